@@ -1,5 +1,8 @@
 #include <QDataStream>
 #include <QBuffer>
+#include <QFile>
+#include <QDir>
+#include <QCryptographicHash>
 #include <syslog.h>
 #include <F24LC256.h>
 
@@ -10,12 +13,15 @@
 cAdjFlash::cAdjFlash(QString devnode, quint8 dlevel, quint8 i2cadr)
     :m_sDeviceNode(devnode), m_nDebugLevel(dlevel), m_nI2CAdr(i2cadr)
 {
+    m_nWritePages = 0;
+    m_nWritePos = 0;
+    m_nPagesWritten = 0;
+    m_nFlashJobs = 0;
 }
 
 
-bool cAdjFlash::exportAdjFlash()
+void cAdjFlash::startFlashWrite()
 {
-    bool ret;
     QByteArray ba;
     QDataStream stream(&ba,QIODevice::ReadWrite);
     stream.setVersion(QDataStream::Qt_5_4);
@@ -28,9 +34,43 @@ bool cAdjFlash::exportAdjFlash()
 
     exportAdjData(stream);
     setAdjCountChecksum(ba);
-    setI2CMux();
-    ret = writeFlash(ba);
-    return ret;
+    beginFlashWrite(ba);
+}
+
+
+bool cAdjFlash::isFlashWriteDone()
+{
+    return (m_nWritePos >= m_nWritePages);
+}
+
+
+int cAdjFlash::getFlashWritePages()
+{
+    return m_nWritePages;
+}
+
+
+int cAdjFlash::getFlashWritePos()
+{
+    return m_nWritePos;
+}
+
+
+void cAdjFlash::addFlashJob()
+{
+    m_nFlashJobs++;
+}
+
+
+void cAdjFlash::removeFlashJob()
+{
+    m_nFlashJobs--;
+}
+
+
+bool cAdjFlash::isFlashJobPending()
+{
+    return (m_nFlashJobs > 0);
 }
 
 
@@ -40,17 +80,21 @@ bool cAdjFlash::importAdjFlash()
 
     setI2CMux();
     if (readFlash(ba)) // if we could read data with correct chksum
-    {
-        QDataStream stream(&ba, QIODevice::ReadOnly);
-        stream.setVersion(QDataStream::Qt_5_4);
-
-        return importAdjData(stream);
-    }
+        return importAdjImage(ba);
     else
         return false;
 }
 
 
+bool cAdjFlash::importAdjImage(QByteArray &ba)
+{
+    QDataStream stream(&ba, QIODevice::ReadOnly);
+    stream.setVersion(QDataStream::Qt_5_4);
+
+    return importAdjData(stream);
+}
+
+
 void cAdjFlash::setAdjCountChecksum(QByteArray &ba)
 {
     quint32 count;
@@ -82,21 +126,67 @@ void cAdjFlash::setAdjCountChecksum(QByteArray &ba)
 }
 
 
-bool cAdjFlash::writeFlash(QByteArray &ba)
+void cAdjFlash::beginFlashWrite(QByteArray &ba)
 {
-    int count, written;
+    if (!isFlashWriteDone())
+        m_ShadowImage.clear(); // an interrupted write left pages we don't know
 
+    m_WriteImage = ba;
+    m_nWritePages = (ba.size() + AdjFlashPageSize - 1) / AdjFlashPageSize;
+    m_nWritePos = 0;
+    m_nPagesWritten = 0;
+}
+
+
+bool cAdjFlash::writeFlashPages(int n)
+{
+    if (isFlashWriteDone())
+        return true;
+
+    int count = m_WriteImage.size();
+    bool ok = true;
+
+    setI2CMux();
     cF24LC256* Flash = new cF24LC256(m_sDeviceNode, m_nDebugLevel,m_nI2CAdr);
-    count = ba.size();
-    written = Flash->WriteData(ba.data(),count,0);
 
-    if ( (count - written) > 0)
+    // we only write pages that differ from our shadow image. page 0 holding count and chksum
+    // is written last, so an interrupted write leaves an image with wrong chksum behind
+    for (int i = 0; (i < n) && (m_nWritePos < m_nWritePages) && ok; i++)
     {
+        m_nWritePos++;
+        int page = m_nWritePos % m_nWritePages;
+        int adr = page * AdjFlashPageSize;
+        int len = qMin(AdjFlashPageSize, count - adr);
+
+        if ( (m_ShadowImage.size() < adr + len) || (m_ShadowImage.mid(adr, len) != m_WriteImage.mid(adr, len)) )
+        {
+            if ( (len - Flash->WriteData(m_WriteImage.data() + adr, len, adr)) > 0)
+                ok = false;
+            else
+                m_nPagesWritten++;
+        }
+    }
+
+    delete Flash;
+
+    if (!ok)
+    {
+         m_ShadowImage.clear(); // we don't know what's in flash now
+         m_WriteImage.clear();
+         m_nWritePos = m_nWritePages = 0;
          if DEBUG1 syslog(LOG_ERR,"error writing flashmemory\n");
          return false; // fehler beim flash schreiben
     }
-    else
-        return true;
+
+    if (isFlashWriteDone())
+    {
+        m_ShadowImage = m_WriteImage;
+        m_WriteImage.clear();
+        writeCache(m_ShadowImage);
+        if DEBUG2 syslog(LOG_INFO,"flashmemory written, %d of %d pages\n", m_nPagesWritten, m_nWritePages);
+    }
+
+    return true;
 }
 
 
@@ -106,13 +196,27 @@ quint16 cAdjFlash::getChecksum()
 }
 
 
+int cAdjFlash::getPagesWritten()
+{
+    return m_nPagesWritten;
+}
+
+
 bool cAdjFlash::readFlash(QByteArray &ba)
+{
+    return readFlashHeader(ba) && readFlashImage(ba);
+}
+
+
+bool cAdjFlash::readFlashHeader(QByteArray &ba, int len)
 {
     cF24LC256* Flash = new cF24LC256(m_sDeviceNode, m_nDebugLevel,m_nI2CAdr);
+    m_ShadowImage.clear(); // valid again only if we read a correct image
 
-    // first we try to read 6 bytes hold length (quint32) and checksum (quint16)
-    ba.resize(6);
-    if ( (6 - Flash->ReadData(ba.data(),6,0)) >0 )
+    // length (quint32) and checksum (quint16) plus what the caller wants to know in advance
+    len = qMax(len, 6);
+    ba.resize(len);
+    if ( (len - Flash->ReadData(ba.data(),len,0)) >0 )
     {
         if DEBUG1 syslog(LOG_ERR,"error reading flashmemory\n");
         delete Flash;
@@ -125,34 +229,138 @@ bool cAdjFlash::readFlash(QByteArray &ba)
     quint32 count;
 
     bastream >> count >> m_nChecksum;
-    if ( count > (quint32)Flash->size() )
+    if ( (count > (quint32)Flash->size()) || (count < 6) )
     {
-        if DEBUG1 syslog(LOG_ERR,"error reading flashmemory, count > flash\n");
+        if DEBUG1 syslog(LOG_ERR,"error reading flashmemory, wrong count\n");
         delete Flash;
         return(false); // read error
     }
 
-    ba.resize(count);
+    if (count < (quint32)len)
+        ba.resize(count); // the caller asked for more than the image has
+
+    delete Flash;
+    return true;
+}
+
 
-    if ( (count - Flash->ReadData(ba.data(),count,0)) >0 )
+bool cAdjFlash::readFlashImage(QByteArray &ba)
+{
+    quint32 count;
+    QDataStream bastream( &ba, QIODevice::ReadOnly );
+    bastream.setVersion(QDataStream::Qt_5_4);
+    bastream >> count;
+
+    bool fromCache = readCache(ba); // if we have this image cached already we don't need the full read
+
+    if (!fromCache)
     {
-        if DEBUG1 syslog(LOG_ERR,"error reading flashmemory\n");
+        cF24LC256* Flash = new cF24LC256(m_sDeviceNode, m_nDebugLevel,m_nI2CAdr);
+        int known = ba.size(); // the header was read already
+        ba.resize(count);
+
+        if ( (int)(count - known) - Flash->ReadData(ba.data() + known, count - known, known) > 0 )
+        {
+            if DEBUG1 syslog(LOG_ERR,"error reading flashmemory\n");
+            delete Flash;
+            return(false); // read error
+        }
         delete Flash;
-        return(false); // read error
     }
 
-    QBuffer mem;
-    mem.setBuffer(&ba);
-    mem.open(QIODevice::ReadWrite);
+    // the chksum is computed with its own bytes 0, ba stays the image as it is in flash
+    QByteArray ca = ba;
+    ca[4] = 0;
+    ca[5] = 0;
 
-    mem.seek(4);
+    quint16 chksum;
+    chksum = qChecksum(ca.data(),ca.size()); // +crc-16
 
-    QByteArray ca(2, 0); // qbyte array mit 6 bytes
-    mem.write(ca); // 0 setzen der checksumme
-    mem.close();
+    if (chksum != m_nChecksum)
+        return false;
 
-    quint16 chksum;
-    chksum = qChecksum(ba.data(),ba.size()); // +crc-16
+    // the cache only matched count, chksum and header. we serve its data, but a write must not
+    // skip pages because of it, maybe the flash was written by another tool meanwhile
+    if (fromCache)
+        m_ShadowImage.clear();
+    else
+    {
+        m_ShadowImage = ba;
+        writeCache(ba);
+    }
+
+    return true; // we could read count bytes and the chksum is ok.
+}
+
+
+QString cAdjFlash::getCacheKey()
+{
+    return QString(); // no cache by default
+}
+
+
+QString cAdjFlash::cacheFileName()
+{
+    QString key = getCacheKey();
 
-    return (chksum == m_nChecksum); // we could read count bytes and the chksum is ok.
+    if (key.isEmpty())
+        return key;
+
+    return QString("%1/%2.adj").arg(adjCachePath).arg(key);
+}
+
+
+bool cAdjFlash::readCache(QByteArray &ba)
+{
+    QString fName = cacheFileName();
+
+    if (fName.isEmpty())
+        return false;
+
+    QFile file(fName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QByteArray digest = file.read(CacheDigestLength);
+    QByteArray cached = file.readAll();
+    file.close();
+
+    // a damaged cache file is detected by its sha-1, the crc-16 alone is too weak for that
+    if (QCryptographicHash::hash(cached, QCryptographicHash::Sha1) != digest)
+        return false;
+
+    // the cached image's count and chksum must be the ones we just read from flash
+    if ( (cached.size() < ba.size()) || (cached.left(ba.size()) != ba) )
+        return false;
+
+    quint32 count;
+    QDataStream castream(&cached, QIODevice::ReadOnly);
+    castream.setVersion(QDataStream::Qt_5_4);
+    castream >> count;
+
+    if (count != (quint32)cached.size())
+        return false;
+
+    if DEBUG2 syslog(LOG_INFO,"adjustment image read from cache %s\n", fName.toLatin1().data());
+    ba = cached;
+    return true;
+}
+
+
+void cAdjFlash::writeCache(QByteArray &ba)
+{
+    QString fName = cacheFileName();
+
+    if (fName.isEmpty())
+        return;
+
+    QDir().mkpath(adjCachePath);
+
+    QFile file(fName);
+    QByteArray digest = QCryptographicHash::hash(ba, QCryptographicHash::Sha1);
+    if ( !file.open(QIODevice::WriteOnly | QIODevice::Truncate) || (file.write(digest) != digest.size()) || (file.write(ba) != ba.size()) )
+    {
+        file.remove(); // no cache is better than a wrong one, the chksum would tell anyway
+        if DEBUG1 syslog(LOG_ERR,"error writing adjustment cache %s\n", fName.toLatin1().data());
+    }
 }
@@ -6,31 +6,55 @@
 
 class QDataStream;
 
+const int AdjFlashPageSize = 64; // 24LC256 write page
+const int CacheDigestLength = 20; // sha-1 of the image in front of a cached image
+
 class cAdjFlash
 {
 public:
-    cAdjFlash(){}
+    cAdjFlash():m_nWritePages(0), m_nWritePos(0), m_nPagesWritten(0), m_nFlashJobs(0){}
     cAdjFlash(QString devnode, quint8 dlevel, quint8 i2cadr);
-    virtual bool exportAdjFlash();
     virtual bool importAdjFlash();
+    void startFlashWrite(); // builds the image, its pages are written by writeFlashPages
+    virtual bool writeFlashPages(int n); // writes the next n pages of the image, false on error, maybe none if the flash is not accessible just now
+    bool isFlashWriteDone();
+    int getFlashWritePages(); // pages of the image we write
+    int getFlashWritePos(); // pages of it we are through
+    void addFlashJob(); // a job writing our flash was queued
+    void removeFlashJob(); // and it is gone
+    virtual bool isFlashJobPending(); // direct flash access must be refused with busy then
 
     virtual quint8 getAdjustmentStatus() = 0;
     quint16 getChecksum();
+    int getPagesWritten(); // pages written by the last flash write
 
 protected:
     QString m_sDeviceNode;
     quint8 m_nI2CAdr;
     quint8 m_nDebugLevel;
     quint16 m_nChecksum;
+    QByteArray m_ShadowImage; // what we know is in flash, last image read from flash or written
+    QByteArray m_WriteImage; // the image we are writing just now
+    int m_nWritePages;
+    int m_nWritePos;
+    int m_nPagesWritten;
+    int m_nFlashJobs;
     virtual void exportAdjData(QDataStream& stream) = 0; // the derived class exports adjdata to qdatastream
     virtual bool importAdjData(QDataStream& stream) = 0; // same for import
 
     bool readFlash(QByteArray& ba);
-    bool writeFlash(QByteArray& ba);
+    bool readFlashHeader(QByteArray& ba, int len = 6); // count, chksum and what follows up to len bytes, less if the image is shorter
+    bool readFlashImage(QByteArray& ba); // completes the image of the header in ba and checks the chksum
+    bool importAdjImage(QByteArray& ba); // imports from an image we read before
+    void beginFlashWrite(QByteArray& ba);
     virtual void setI2CMux() = 0; // default we do nothing here but if necessary it can be overwritten
+    virtual QString getCacheKey(); // identifies the flash owner for the local image cache, empty -> no cache
 
 private:
     void setAdjCountChecksum(QByteArray& ba);
+    QString cacheFileName();
+    bool readCache(QByteArray& ba); // ba holds the flash header, on match it returns the cached image
+    void writeCache(QByteArray& ba);
 };
 
 #endif // ADJFLASH_H
@@ -1,9 +1,11 @@
 #include <QFile>
-#include <QDomDocument>
-#include <QTextStream>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <syslog.h>
 
 #include "adjxml.h"
+#include "justdata.h"
+#include "mt310s2justdata.h"
 #include "mt310s2dglobal.h"
 
 
@@ -24,17 +26,37 @@ bool cAdjXML::exportAdjXML(QString file)
         return false;
     }
 
-    QString sXML;
-
-    sXML = exportXMLString();
-    QTextStream stream( &adjfile );
-    stream << sXML;
+    // we stream directly into the file, formatted like QDomDocument::toString(1) did
+    QXmlStreamWriter writer(&adjfile);
+    writer.setAutoFormatting(true);
+    writer.setAutoFormattingIndent(1);
+    exportXML(writer);
+    adjfile.write("\n");
     adjfile.close();
 
     return true;
 }
 
 
+QString cAdjXML::exportXMLString(int indent)
+{
+    QString sXML;
+    QXmlStreamWriter writer(&sXML);
+
+    if (indent >= 0)
+    {
+        writer.setAutoFormatting(true);
+        writer.setAutoFormattingIndent(indent);
+    }
+
+    exportXML(writer);
+    if (indent >= 0)
+        sXML.append('\n');
+
+    return sXML;
+}
+
+
 bool cAdjXML::importAdjXML(QString file)
 {
     QString filename = file + ".xml";
@@ -47,32 +69,148 @@ bool cAdjXML::importAdjXML(QString file)
         return false;
     }
 
-    QDomDocument justqdom( "TheDocument" );
-    if ( !justqdom.setContent( &adjfile ) )
-    {
-        adjfile.close();
-        if ((DebugLevel & 1) != 0)
-            syslog(LOG_ERR,"justdata import, format error in xml file\n");
-        return false;
-    }
-
+    QXmlStreamReader reader(&adjfile);
+    bool ret = importXML(reader);
     adjfile.close();
 
-    return importXMLDocument(&justqdom);
+    return ret;
 }
 
 
 bool cAdjXML::importAdjXMLString(QString &xml)
 {
-    QDomDocument justqdom( "TheDocument" );
-    if ( !justqdom.setContent(xml) )
+    QXmlStreamReader reader(xml);
+    return importXML(reader);
+}
+
+
+void cAdjXML::writeXMLText(QXmlStreamWriter &writer, const QString &tag, const QString &text)
+{
+    if (text.isEmpty())
+        writer.writeEmptyElement(tag); // <tag/> as dom did
+    else
+        writer.writeTextElement(tag, text);
+}
+
+
+void cAdjXML::writeXMLCorrection(QXmlStreamWriter &writer, const QString &tag, cJustData *justData)
+{
+    writer.writeStartElement(tag);
+    writeXMLText(writer, "Status", justData->SerializeStatus());
+    writeXMLText(writer, "Coefficients", justData->SerializeCoefficients());
+    writeXMLText(writer, "Nodes", justData->SerializeNodes());
+    writer.writeEndElement();
+}
+
+
+bool cAdjXML::readXMLDocType(QXmlStreamReader &reader, const QString &docType)
+{
+    bool docTypeOK = false;
+
+    while (!reader.atEnd())
+    {
+        reader.readNext();
+        if (reader.isDTD())
+            docTypeOK = (reader.dtdName() == docType);
+        else
+            if (reader.isStartElement())
+                break;
+    }
+
+    if (!docTypeOK)
     {
         if ((DebugLevel & 1) != 0)
-            syslog(LOG_ERR,"justdata import, format error in xml file\n");
-        return false;
+            syslog(LOG_ERR,"justdata import, wrong xml documentype\n");
+    }
+
+    return docTypeOK && reader.isStartElement();
+}
+
+
+bool cAdjXML::readXMLRange(QXmlStreamReader &reader, QString &name, QList<cAdjXMLCorrection> &corrList)
+{
+    while (reader.readNextStartElement())
+    {
+        QString tName = reader.name().toString();
+
+        if (tName == "Name")
+            name = reader.readElementText();
+
+        else
+
+        if ( (tName == "Gain") || (tName == "Phase") || (tName == "Offset") )
+        {
+            cAdjXMLCorrection corr;
+            corr.m_sType = tName;
+
+            while (reader.readNextStartElement())
+            {
+                QString jTypeName = reader.name().toString();
+
+                if (jTypeName == "Status")
+                {
+                    corr.m_sStatus = reader.readElementText();
+                    corr.m_nParts |= AdjXML::partStatus;
+                }
+                else
+                if (jTypeName == "Coefficients")
+                {
+                    corr.m_sCoefficients = reader.readElementText();
+                    corr.m_nParts |= AdjXML::partCoefficients;
+                }
+                else
+                if (jTypeName == "Nodes")
+                {
+                    corr.m_sNodes = reader.readElementText();
+                    corr.m_nParts |= AdjXML::partNodes;
+                }
+                else
+                    reader.skipCurrentElement();
+            }
+
+            corrList.append(corr);
+        }
+
+        else
+            reader.skipCurrentElement();
     }
 
-    return importXMLDocument(&justqdom);
+    return !reader.hasError();
+}
+
+
+void cAdjXML::stageXMLRange(cMT310S2JustData *justData, QList<cAdjXMLCorrection> &corrList, QList<cAdjXMLCorrection> &stage)
+{
+    for (int i = 0; i < corrList.count(); i++)
+    {
+        cAdjXMLCorrection corr = corrList.at(i);
+
+        if (corr.m_sType == "Gain")
+            corr.m_pJustData = justData->m_pGainCorrection;
+        else
+        if (corr.m_sType == "Phase")
+            corr.m_pJustData = justData->m_pPhaseCorrection;
+        else
+            corr.m_pJustData = justData->m_pOffsetCorrection;
+
+        stage.append(corr);
+    }
 }
 
 
+void cAdjXML::commitXMLCorrections(QList<cAdjXMLCorrection> &stage)
+{
+    for (int i = 0; i < stage.count(); i++)
+    {
+        const cAdjXMLCorrection& corr = stage.at(i);
+
+        if (corr.m_nParts & AdjXML::partStatus)
+            corr.m_pJustData->DeserializeStatus(corr.m_sStatus);
+
+        if (corr.m_nParts & AdjXML::partCoefficients)
+            corr.m_pJustData->DeserializeCoefficients(corr.m_sCoefficients);
+
+        if (corr.m_nParts & AdjXML::partNodes)
+            corr.m_pJustData->DeserializeNodes(corr.m_sNodes);
+    }
+}
@@ -2,22 +2,59 @@
 #define ADJXML_H
 
 #include <QString>
+#include <QList>
+
+class QXmlStreamWriter;
+class QXmlStreamReader;
+class cJustData;
+class cMT310S2JustData;
+
+namespace AdjXML
+{
+    enum CorrectionParts
+    {
+        partStatus = 1,
+        partCoefficients = 2,
+        partNodes = 4
+    };
+}
+
+
+class cAdjXMLCorrection // xml values for 1 correction, staged until the whole document was read
+{
+public:
+    cAdjXMLCorrection():m_pJustData(0), m_nParts(0){}
+    QString m_sType; // Gain, Phase or Offset
+    cJustData* m_pJustData;
+    quint8 m_nParts; // which of the parts we found
+    QString m_sStatus;
+    QString m_sCoefficients;
+    QString m_sNodes;
+};
 
-class QDomDocument;
 
 class cAdjXML
 {
 public:
-    cAdjXML(){}
+    cAdjXML():DebugLevel(0){}
     cAdjXML(quint8 dlevel);
 
     virtual bool exportAdjXML(QString file);
     virtual bool importAdjXML(QString file);
     virtual bool importAdjXMLString(QString& xml);
+    QString exportXMLString(int indent = 1); // adjustment data xml export to string, indent < 0 -> 1 line
 
 protected:
-    virtual QString exportXMLString(int indent = 1) = 0; // adjustment data xml export to string
-    virtual bool importXMLDocument(QDomDocument* qdomdoc) = 0;
+    virtual void exportXML(QXmlStreamWriter& writer) = 0; // the derived class streams its adjustment document
+    virtual bool importXML(QXmlStreamReader& reader) = 0; // same for import, nothing is taken over if it fails
+
+    void writeXMLText(QXmlStreamWriter& writer, const QString& tag, const QString& text);
+    void writeXMLCorrection(QXmlStreamWriter& writer, const QString& tag, cJustData* justData); // status, coefficients, nodes
+
+    bool readXMLDocType(QXmlStreamReader& reader, const QString& docType); // leaves reader on the root element
+    bool readXMLRange(QXmlStreamReader& reader, QString& name, QList<cAdjXMLCorrection>& corrList); // reader on <Range>
+    void stageXMLRange(cMT310S2JustData* justData, QList<cAdjXMLCorrection>& corrList, QList<cAdjXMLCorrection>& stage);
+    void commitXMLCorrections(QList<cAdjXMLCorrection>& stage);
 
 private:
     quint8 DebugLevel;
@@ -6,8 +6,12 @@
 #include "atmel.h"
 
 
+static const qint64 SharedReadWindow = 20; // ms, results older than this are read again
+
+
 cATMEL::cATMEL(QString devnode, quint8 adr, quint8 debuglevel)
-    :m_sI2CDevNode(devnode), m_nI2CAdr(adr), m_nDebugLevel(debuglevel)
+    :m_sI2CDevNode(devnode), m_nI2CAdr(adr), m_nDebugLevel(debuglevel),
+      m_DeviceAvailRead(SharedReadWindow), m_CriticalStatusRead(SharedReadWindow), m_EEPROMAccessRead(SharedReadWindow)
 {
     m_pCRCGenerator = new cMaxim1WireCRC();
 }
@@ -181,6 +185,7 @@ atmelRM cATMEL::resetCriticalStatus(quint16 stat)
 
     hw_cmd CMD = {hwResetCritStat, 0, PAR, 2, 0, 0, 0 };
 
+    m_CriticalStatusRead.invalidate(); // the next status query must see the reset
     if  ( (writeCommand(&CMD) == 0) && (CMD.RM == 0) )
         return cmddone;
     else
@@ -290,6 +295,65 @@ atmelRM cATMEL::getEEPROMAccessEnable(bool &enable)
 }
 
 
+atmelRM cATMEL::readDeviceAvailShared()
+{
+    quint16 dummy;
+
+    if (m_DeviceAvailRead.take(dummy))
+        return cmddone;
+
+    QString s;
+    atmelRM ret = readDeviceName(s);
+    if (ret == cmddone) // we only share successful reads, errors are tried again
+        m_DeviceAvailRead.store(0);
+
+    return ret;
+}
+
+
+atmelRM cATMEL::readCriticalStatusShared(quint16 &stat)
+{
+    if (m_CriticalStatusRead.take(stat))
+        return cmddone;
+
+    atmelRM ret = readCriticalStatus(stat);
+    if (ret == cmddone)
+        m_CriticalStatusRead.store(stat);
+
+    return ret;
+}
+
+
+atmelRM cATMEL::getEEPROMAccessEnableShared(bool &enable)
+{
+    quint16 value;
+
+    if (m_EEPROMAccessRead.take(value))
+    {
+        enable = (value != 0);
+        return cmddone;
+    }
+
+    atmelRM ret = getEEPROMAccessEnable(enable);
+    if (ret == cmddone)
+        m_EEPROMAccessRead.store(enable ? 1 : 0);
+
+    return ret;
+}
+
+
+quint32 cATMEL::getSharedReadCount()
+{
+    return m_DeviceAvailRead.getReadCount() + m_CriticalStatusRead.getReadCount() + m_EEPROMAccessRead.getReadCount();
+}
+
+
+quint32 cATMEL::getSavedReadCount()
+{
+    return m_DeviceAvailRead.getSavedCount() + m_CriticalStatusRead.getSavedCount() + m_EEPROMAccessRead.getSavedCount();
+}
+
+
 atmelRM cATMEL::readSamplingRange(quint8 &srange)
 {
     srange = 0;
@@ -543,11 +607,27 @@ quint8* cATMEL::GenAdressPointerParameter(quint8 adresspointerSize, quint32 adr)
 
 
 atmelRM cATMEL::loadMemory(bl_cmdcode blwriteCmd, cIntelHexFileIO& ihxFIO)
+{
+    blLoadState state;
+    atmelRM ret;
+
+    ret = startLoadMemory(blwriteCmd, ihxFIO, state);
+    while ( (state.MemByteArray.count()) && (ret == cmddone) ) // as long we get data from hexfile
+        ret = loadMemoryBlock(ihxFIO, state);
+
+    return ret;
+}
+
+
+atmelRM cATMEL::startLoadMemory(bl_cmdcode blwriteCmd, cIntelHexFileIO &ihxFIO, blLoadState &state)
 {
     atmelRM  ret = cmddone;
     quint8 PAR[1];
     bl_cmd blInfoCMD = {blReadInfo, PAR, 0, 0, 0, 0};
 
+    state.blwriteCmd = blwriteCmd;
+    state.MemByteArray.clear();
+
     quint16 dlen = writeBootloaderCommand(&blInfoCMD);
 
     if ( (dlen > 5) && (blInfoCMD.RM == 0) ) // we must get at least 6 bytes
@@ -557,47 +637,47 @@ atmelRM cATMEL::loadMemory(bl_cmdcode blwriteCmd, cIntelHexFileIO& ihxFIO)
         int read = readOutput(blInput, dlen);
         if ( read == dlen) // we got the reqired information from bootloader
         {
-            blInfo BootloaderInfo;
-            quint8* dest = (quint8*) &BootloaderInfo;
+            quint8* dest = (quint8*) &state.BootloaderInfo;
             int pos = strlen(blInput);
             int i;
             for (i = 0; i < 4; i++)
                 dest[i ^ 1] = blInput[pos+1+i]; // little endian ... big endian
 
             dest[i] = blInput[pos+1+i];
-            quint32 MemAdress = 0;
-            quint32 MemOffset;
-            QByteArray MemByteArray;
-
-            ihxFIO.GetMemoryBlock( BootloaderInfo.MemPageSize, MemAdress, MemByteArray, MemOffset);
-            while ( (MemByteArray.count()) && (ret == cmddone) ) // as long we get data from hexfile
-            {
-                quint8* adrParameter;
-                quint16 adrParLen = BootloaderInfo.AdressPointerSize;
-                adrParameter = GenAdressPointerParameter(adrParLen, MemAdress);
-
-                bl_cmd blAdressCMD = {blWriteAddressPointer, adrParameter, adrParLen, 0, 0, 0};
-
-                if ( (writeBootloaderCommand(&blAdressCMD) == 0) && (blAdressCMD.RM == 0) )
-                { // we were able to write the adress
-                    quint8* memdat = (quint8*)MemByteArray.data();
-                    quint16 memlen = MemByteArray.count();
-
-                    bl_cmd blwriteMemCMD = {blwriteCmd, memdat, memlen, 0, 0, 0};
-
-                    if ( (writeBootloaderCommand(&blwriteMemCMD) == 0) && (blwriteMemCMD.RM == 0) )
-                    { // we were able to write the data and expect the data to be in flash when sent over i2c
-                        MemAdress += BootloaderInfo.MemPageSize;
-                        ihxFIO.GetMemoryBlock( BootloaderInfo.MemPageSize, MemAdress, MemByteArray, MemOffset); // versuch weitere daten aus hexfile zu lesen
-                    }
-                    else
-                        ret = cmdexecfault;
-                }
-                else
-                    ret = cmdexecfault;
-
-                delete adrParameter;
-            }
+            state.MemAdress = 0;
+
+            ihxFIO.GetMemoryBlock( state.BootloaderInfo.MemPageSize, state.MemAdress, state.MemByteArray, state.MemOffset);
+        }
+        else
+            ret = cmdexecfault;
+    }
+    else
+        ret = cmdexecfault;
+
+    return ret;
+}
+
+
+atmelRM cATMEL::loadMemoryBlock(cIntelHexFileIO &ihxFIO, blLoadState &state)
+{
+    atmelRM  ret = cmddone;
+    quint8* adrParameter;
+    quint16 adrParLen = state.BootloaderInfo.AdressPointerSize;
+    adrParameter = GenAdressPointerParameter(adrParLen, state.MemAdress);
+
+    bl_cmd blAdressCMD = {blWriteAddressPointer, adrParameter, adrParLen, 0, 0, 0};
+
+    if ( (writeBootloaderCommand(&blAdressCMD) == 0) && (blAdressCMD.RM == 0) )
+    { // we were able to write the adress
+        quint8* memdat = (quint8*)state.MemByteArray.data();
+        quint16 memlen = state.MemByteArray.count();
+
+        bl_cmd blwriteMemCMD = {state.blwriteCmd, memdat, memlen, 0, 0, 0};
+
+        if ( (writeBootloaderCommand(&blwriteMemCMD) == 0) && (blwriteMemCMD.RM == 0) )
+        { // we were able to write the data and expect the data to be in flash when sent over i2c
+            state.MemAdress += state.BootloaderInfo.MemPageSize;
+            ihxFIO.GetMemoryBlock( state.BootloaderInfo.MemPageSize, state.MemAdress, state.MemByteArray, state.MemOffset); // versuch weitere daten aus hexfile zu lesen
         }
         else
             ret = cmdexecfault;
@@ -605,5 +685,6 @@ atmelRM cATMEL::loadMemory(bl_cmdcode blwriteCmd, cIntelHexFileIO& ihxFIO)
     else
         ret = cmdexecfault;
 
+    delete adrParameter;
     return ret;
 }
@@ -2,9 +2,12 @@
 #define ATMEL_H
 
 #include <QString>
+#include <QByteArray>
 #include <intelhexfileio.h>
 #include <crcutils.h>
 
+#include "sharedread.h"
+
 enum hw_cmdcode
 {
     hwGetSerialNr = 0x0001,
@@ -89,6 +92,16 @@ struct blInfo {
 };
 
 
+struct blLoadState // where we are while loading flash or eeprom block by block
+{
+    bl_cmdcode blwriteCmd;
+    blInfo BootloaderInfo;
+    quint32 MemAdress;
+    quint32 MemOffset;
+    QByteArray MemByteArray; // the next block, empty if all blocks are written
+};
+
+
 enum atmelRM
 {
     cmddone,
@@ -115,6 +128,8 @@ public:
     atmelRM startProgram();
     atmelRM loadFlash(cIntelHexFileIO& ihxFIO);
     atmelRM loadEEprom(cIntelHexFileIO& ihxFIO);
+    atmelRM startLoadMemory(bl_cmdcode blwriteCmd, cIntelHexFileIO& ihxFIO, blLoadState& state); // for loading in steps
+    atmelRM loadMemoryBlock(cIntelHexFileIO& ihxFIO, blLoadState& state);
     atmelRM readChannelStatus(quint8 channel, quint8& stat);
     atmelRM readCriticalStatus(quint16& stat);
     atmelRM resetCriticalStatus(quint16 stat);
@@ -133,6 +148,13 @@ public:
     atmelRM setPLLChannel(quint8 chn);
     atmelRM readPLLChannel(quint8& chn);
 
+    // status queries of several clients arriving at once share 1 i2c read
+    atmelRM readDeviceAvailShared();
+    atmelRM readCriticalStatusShared(quint16& stat);
+    atmelRM getEEPROMAccessEnableShared(bool& enable);
+    quint32 getSharedReadCount(); // hardware reads done for shared queries
+    quint32 getSavedReadCount(); // hardware reads spared
+
 private:
     atmelRM mGetText(hw_cmdcode hwcmd,QString& answer);
     void GenCommand(hw_cmd* hc);
@@ -147,6 +169,10 @@ private:
     QString m_sI2CDevNode;
     quint8 m_nI2CAdr;
     quint8 m_nDebugLevel;
+
+    cSharedRead m_DeviceAvailRead;
+    cSharedRead m_CriticalStatusRead;
+    cSharedRead m_EEPROMAccessRead;
 };
 
 #endif // ATMEL_H
@@ -0,0 +1,28 @@
+TEMPLATE	= app
+LANGUAGE	= C++
+
+QT += core
+QT -= gui
+
+CONFIG	+= console release
+CONFIG	-= app_bundle
+
+TARGET = answerpath-bench
+
+# the command, its answer handler and the delegate are taken from the server as they are
+INCLUDEPATH += ../..
+
+LIBS +=  -lSCPI
+
+HEADERS	+= \
+    ../../protonetcommand.h \
+    ../../parsedcommand.h \
+    ../../scpidelegate.h \
+    ../../scpiconnection.h
+
+SOURCES	+= \
+    main.cpp \
+    ../../protonetcommand.cpp \
+    ../../parsedcommand.cpp \
+    ../../scpidelegate.cpp \
+    ../../scpiconnection.cpp
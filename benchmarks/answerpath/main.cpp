@@ -0,0 +1,181 @@
+// per command completion overhead for a correction node command
+// before: the delegate emits execute, the adjustment data emits cmdExecutionDone and every
+//         parent re-emits it (mt310s2 justdata, range, [clamp,] channel, interface) up to the server
+// after:  the delegate calls its connection directly and the command calls its answer handler
+// both ways run through the server's own cSCPIDelegate, only its setConnection() differs
+//
+// usage: answerpath-bench [commands]
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QList>
+#include <scpi.h>
+#include <stdio.h>
+
+#include "protonetcommand.h"
+#include "scpidelegate.h"
+#include "scpiconnection.h"
+
+
+class cBenchServer: public QObject, public cAnswerHandler // counts the answers it would send
+{
+    Q_OBJECT
+
+public:
+    cBenchServer():m_nAnswers(0){}
+    quint32 m_nAnswers;
+
+public slots:
+    virtual void sendAnswer(cProtonetCommand* protoCmd)
+    {
+        if (protoCmd->m_bwithOutput)
+            m_nAnswers++;
+    }
+};
+
+
+class cBenchNode: public QObject // one object of the sense tree, before it only relayed the answer
+{
+    Q_OBJECT
+
+signals:
+    void cmdExecutionDone(cProtonetCommand* protoCmd);
+};
+
+
+class cBenchJustData: public cSCPIConnection // the correction that executes the command
+{
+    Q_OBJECT
+
+public:
+    cBenchJustData(cSCPI* scpiInterface, bool direct):m_bDirect(direct) { m_pSCPIInterface = scpiInterface; }
+    virtual void initSCPIConnection(QString) {}
+    bool m_bDirect;
+
+signals:
+    void cmdExecutionDone(cProtonetCommand* protoCmd);
+
+protected slots:
+    virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd)
+    {
+        protoCmd->m_sOutput = QString("%1").arg(cmdCode);
+        if (m_bDirect)
+            protoCmd->sendAnswer();
+        else
+            emit cmdExecutionDone(protoCmd);
+    }
+};
+
+
+static cSCPIDelegate* createDelegate(cSCPI* scpiInterface)
+{
+    return new cSCPIDelegate("SENSE:m0:250V:CORRECTION:GAIN", "STATUS", SCPI::isQuery, scpiInterface, 0);
+}
+
+
+static void deleteDelegate(cSCPI* scpiInterface, cSCPIDelegate* delegate) // like cSCPIConnection does it
+{
+    scpiInterface->delSCPICmds(delegate->getCommand());
+    delete delegate;
+}
+
+
+static double runCommands(cSCPIDelegate* delegate, cProtonetCommand& protoCmd, int n)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < n; i++)
+        delegate->executeSCPI(&protoCmd);
+
+    return (double)timer.nsecsElapsed() / n;
+}
+
+
+// relays: the names of the objects that re-emitted the answer before
+static double runBefore(cSCPI* scpiInterface, const QStringList& relays, int n, quint32& answers)
+{
+    cBenchServer server;
+    cSCPIDelegate* delegate = createDelegate(scpiInterface);
+    cBenchJustData justData(scpiInterface, false);
+    QList<cBenchNode*> nodeList;
+    QObject* last = &justData;
+
+    QObject::connect(delegate, SIGNAL(execute(int,cProtonetCommand*)), &justData, SLOT(executeCommand(int,cProtonetCommand*)));
+    for (int i = 0; i < relays.count(); i++)
+    {
+        cBenchNode* node = new cBenchNode;
+        node->setObjectName(relays.at(i));
+        QObject::connect(last, SIGNAL(cmdExecutionDone(cProtonetCommand*)), node, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
+        nodeList.append(node);
+        last = node;
+    }
+    QObject::connect(last, SIGNAL(cmdExecutionDone(cProtonetCommand*)), &server, SLOT(sendAnswer(cProtonetCommand*)));
+
+    cProtonetCommand protoCmd(0, false, true, QByteArray(), 1, "SENSE:m0:250V:CORRECTION:GAIN:STATUS?", &server);
+    double ns = runCommands(delegate, protoCmd, n);
+
+    answers = server.m_nAnswers;
+    qDeleteAll(nodeList);
+    deleteDelegate(scpiInterface, delegate);
+    return ns;
+}
+
+
+static double runAfter(cSCPI* scpiInterface, int n, quint32& answers)
+{
+    cBenchServer server;
+    cSCPIDelegate* delegate = createDelegate(scpiInterface);
+    cBenchJustData justData(scpiInterface, true);
+
+    delegate->setConnection(&justData);
+
+    cProtonetCommand protoCmd(0, false, true, QByteArray(), 1, "SENSE:m0:250V:CORRECTION:GAIN:STATUS?", &server);
+    double ns = runCommands(delegate, protoCmd, n);
+
+    answers = server.m_nAnswers;
+    deleteDelegate(scpiInterface, delegate);
+    return ns;
+}
+
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    cSCPI scpiInterface("answerpath-bench");
+    QStringList args = app.arguments();
+    int n = 1000000;
+
+    if (args.count() > 1)
+        n = args.at(1).toInt();
+
+    QStringList senseRelays = QStringList() << "mt310s2justdata" << "range" << "channel" << "interface";
+    QStringList clampRelays = QStringList() << "mt310s2justdata" << "range" << "clamp" << "channel" << "interface";
+
+    quint32 answers[4];
+    double ns[4];
+
+    runAfter(&scpiInterface, n / 10, answers[0]); // warm up
+    ns[0] = runBefore(&scpiInterface, senseRelays, n, answers[0]);
+    ns[1] = runAfter(&scpiInterface, n, answers[1]);
+    ns[2] = runBefore(&scpiInterface, clampRelays, n, answers[2]);
+    ns[3] = runAfter(&scpiInterface, n, answers[3]);
+
+    printf("%d correction node commands\n", n);
+    printf("%-14s %16s %16s\n", "range", "before [ns/cmd]", "after [ns/cmd]");
+    printf("%-14s %16.1f %16.1f\n", "sense range", ns[0], ns[1]);
+    printf("%-14s %16.1f %16.1f\n", "clamp range", ns[2], ns[3]);
+
+    for (int i = 0; i < 4; i++)
+        if (answers[i] != (quint32)n)
+        {
+            printf("answer count wrong: %u of %d\n", answers[i], n);
+            return 1;
+        }
+
+    return 0;
+}
+
+#include "main.moc"
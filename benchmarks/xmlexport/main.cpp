@@ -0,0 +1,374 @@
+// adjustment xml export benchmark
+// exports a synthetic full adjustment set (all sense channels of mt310s2d plus 3 clamps)
+// the old way (QDomDocument + toString + replace) and the new way, the server's own
+// cAdjXML::exportXMLString(-1) with its writer helpers and real cJustData objects
+// each way runs in its own process, so peak memory (VmHWM) is measured per way
+//
+// usage: xmlexport-bench [dom|stream] [loops]
+
+#include <QCoreApplication>
+#include <QDomDocument>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QProcess>
+#include <QStringList>
+#include <QFile>
+#include <QList>
+#include <stdio.h>
+
+#include "adjxml.h"
+#include "justdata.h"
+#include "mt310s2justdata.h"
+
+class cATMEL;
+cATMEL* pAtmel = 0; // justdata needs it for its scpi commands only, we never call them
+
+
+static cJustData* createCorrection(int order, int seed) // status, coefficients and nodes set like an adjusted one
+{
+    cJustData* justData = new cJustData(0, order, 0.0);
+    QString coefficients, nodes;
+
+    for (int i = 0; i < order + 1; i++)
+    {
+        coefficients += QString("%1;").arg(1.0 / (seed + i + 1),0,'f',12);
+        nodes += QString("%1;%2;").arg(1.0 + 0.0001 * (seed + i),0,'f',6).arg(10.0 * i,0,'f',6);
+    }
+
+    justData->DeserializeStatus(QString("%1").arg(JustData::Justified));
+    justData->DeserializeCoefficients(coefficients);
+    justData->DeserializeNodes(nodes);
+    return justData;
+}
+
+
+class cBenchRange
+{
+public:
+    cBenchRange(QString name, int seed)
+        :m_sName(name),
+         m_pGain(createCorrection(GainCorrOrder, seed)),
+         m_pPhase(createCorrection(PhaseCorrOrder, seed + 1)),
+         m_pOffset(createCorrection(OffsetCorrOrder, seed + 2)){}
+    ~cBenchRange() { delete m_pGain; delete m_pPhase; delete m_pOffset; }
+    QString m_sName;
+    cJustData* m_pGain;
+    cJustData* m_pPhase;
+    cJustData* m_pOffset;
+};
+
+
+class cBenchDocument // 1 adjustment document, pcb or clamp
+{
+public:
+    ~cBenchDocument();
+    QString m_sDocType, m_sRootTag, m_sType, m_sSerial;
+    QList<QString> m_ChannelNames; // empty for clamps, they have no channel level
+    QList<QList<cBenchRange*> > m_RangeLists;
+};
+
+
+cBenchDocument::~cBenchDocument()
+{
+    for (int i = 0; i < m_RangeLists.count(); i++)
+        qDeleteAll(m_RangeLists[i]);
+}
+
+
+static QList<cBenchRange*> createRanges(const char* names[], int count, int& seed)
+{
+    QList<cBenchRange*> list;
+    for (int i = 0; i < count; i++, seed += 3)
+        list.append(new cBenchRange(names[i], seed));
+    return list;
+}
+
+
+// the range names and counts are the ones senseinterface.cpp and clamp.cpp use
+static const char* VoltageRanges[] = { "250V", "8V", "100mV" };
+static const char* CurrentRanges[] = { "10A", "5A", "2.5A", "1.0A", "500mA", "250mA", "100mA", "50mA", "25mA",
+                                       "8V", "5V", "2V", "1V", "500mV", "200mV", "100mV", "50mV", "20mV", "10mV", "5mV", "2mV" };
+static const char* AuxRanges[] = { "0A", "8V", "5V", "2V", "1V", "500mV", "200mV", "100mV", "50mV", "20mV", "10mV", "5mV", "2mV" };
+static const char* CL120ARanges[] = { "C100A", "C50A", "C10A", "C5A", "C1A", "C500mA", "C100mA", "C50mA", "C10mA" };
+static const char* CL300ARanges[] = { "C300A", "C150A", "C30A", "C15A", "C3A", "C1.5A", "C300mA", "C150mA" };
+static const char* CL1000ARanges[] = { "C1000A", "C300A", "C100A", "C30A", "C10A", "C3A", "C1A", "C300mA" };
+
+#define COUNT(a) (int)(sizeof(a) / sizeof(a[0]))
+
+
+static QList<cBenchDocument*> createFullSet()
+{
+    QList<cBenchDocument*> set;
+    int seed = 0;
+
+    cBenchDocument* pcb = new cBenchDocument;
+    pcb->m_sDocType = "PCBAdjustmentData";
+    pcb->m_sRootTag = "PCB";
+    pcb->m_sType = "mt310s2";
+    pcb->m_sSerial = "050059999";
+    for (int i = 0; i < 8; i++)
+    {
+        pcb->m_ChannelNames.append(QString("m%1").arg(i));
+        if (i == 7)
+            pcb->m_RangeLists.append(createRanges(AuxRanges, COUNT(AuxRanges), seed));
+        else
+            if ((i >= 3) && (i <= 5))
+                pcb->m_RangeLists.append(createRanges(CurrentRanges, COUNT(CurrentRanges), seed));
+            else
+                pcb->m_RangeLists.append(createRanges(VoltageRanges, COUNT(VoltageRanges), seed));
+    }
+    set.append(pcb);
+
+    const char** clampRanges[] = { CL120ARanges, CL300ARanges, CL1000ARanges };
+    int clampCounts[] = { COUNT(CL120ARanges), COUNT(CL300ARanges), COUNT(CL1000ARanges) };
+    const char* clampNames[] = { "CL120A", "CL300A", "CL1000A" };
+
+    for (int i = 0; i < 3; i++)
+    {
+        cBenchDocument* clamp = new cBenchDocument;
+        clamp->m_sDocType = "ClampAdjustmentData";
+        clamp->m_sRootTag = "CLAMP";
+        clamp->m_sType = clampNames[i];
+        clamp->m_sSerial = QString("clamp%1").arg(i);
+        clamp->m_RangeLists.append(createRanges(clampRanges[i], clampCounts[i], seed));
+        set.append(clamp);
+    }
+
+    return set;
+}
+
+
+// the old export, as senseinterface and clamp built it before the stream writer
+static void domText(QDomDocument& doc, QDomElement& parent, const QString& tag, const QString& text)
+{
+    QDomElement e = doc.createElement(tag);
+    parent.appendChild(e);
+    e.appendChild(doc.createTextNode(text));
+}
+
+
+static void domCorrection(QDomDocument& doc, QDomElement& parent, const QString& tag, cJustData* corr)
+{
+    QDomElement e = doc.createElement(tag);
+    parent.appendChild(e);
+    domText(doc, e, "Status", corr->SerializeStatus());
+    domText(doc, e, "Coefficients", corr->SerializeCoefficients());
+    domText(doc, e, "Nodes", corr->SerializeNodes());
+}
+
+
+static void domRanges(QDomDocument& doc, QDomElement& parent, QList<cBenchRange*>& list)
+{
+    for (int j = 0; j < list.count(); j++)
+    {
+        QDomElement rtag = doc.createElement("Range");
+        parent.appendChild(rtag);
+        domText(doc, rtag, "Name", list.at(j)->m_sName);
+        domCorrection(doc, rtag, "Gain", list.at(j)->m_pGain);
+        domCorrection(doc, rtag, "Phase", list.at(j)->m_pPhase);
+        domCorrection(doc, rtag, "Offset", list.at(j)->m_pOffset);
+    }
+}
+
+
+static QString exportDom(cBenchDocument* bdoc)
+{
+    QDomDocument doc(bdoc->m_sDocType);
+
+    QDomElement root = doc.createElement(bdoc->m_sRootTag);
+    doc.appendChild(root);
+    domText(doc, root, "Type", bdoc->m_sType);
+    domText(doc, root, "VersionNumber", "V1.00");
+    domText(doc, root, "SerialNumber", bdoc->m_sSerial);
+    domText(doc, root, "Date", "Mon Oct 19 2026");
+    domText(doc, root, "Time", "08:00:00");
+
+    QDomElement adjtag = doc.createElement("Adjustment");
+    root.appendChild(adjtag);
+    domText(doc, adjtag, "Chksum", "0x1234");
+
+    QDomElement sensetag = doc.createElement("Sense");
+    adjtag.appendChild(sensetag);
+
+    if (bdoc->m_ChannelNames.isEmpty())
+        domRanges(doc, sensetag, bdoc->m_RangeLists[0]);
+    else
+        for (int i = 0; i < bdoc->m_ChannelNames.count(); i++)
+        {
+            QDomElement chtag = doc.createElement("Channel");
+            sensetag.appendChild(chtag);
+            domText(doc, chtag, "Name", bdoc->m_ChannelNames.at(i));
+            domRanges(doc, chtag, bdoc->m_RangeLists[i]);
+        }
+
+    QString s = doc.toString(-1);
+    s.replace("\n","");
+    return s;
+}
+
+
+// the new export, a cAdjXML streaming the document like senseinterface and clamp do
+class cBenchAdjXML: public cAdjXML
+{
+public:
+    cBenchAdjXML(cBenchDocument* bdoc):m_pDoc(bdoc){}
+
+protected:
+    virtual void exportXML(QXmlStreamWriter& writer);
+    virtual bool importXML(QXmlStreamReader&) { return false; } // we only export
+
+private:
+    void exportRanges(QXmlStreamWriter& writer, QList<cBenchRange*>& list);
+    cBenchDocument* m_pDoc;
+};
+
+
+void cBenchAdjXML::exportRanges(QXmlStreamWriter &writer, QList<cBenchRange*> &list)
+{
+    for (int j = 0; j < list.count(); j++)
+    {
+        writer.writeStartElement("Range");
+        writeXMLText(writer, "Name", list.at(j)->m_sName);
+        writeXMLCorrection(writer, "Gain", list.at(j)->m_pGain);
+        writeXMLCorrection(writer, "Phase", list.at(j)->m_pPhase);
+        writeXMLCorrection(writer, "Offset", list.at(j)->m_pOffset);
+        writer.writeEndElement(); // Range
+    }
+}
+
+
+void cBenchAdjXML::exportXML(QXmlStreamWriter &writer)
+{
+    writer.writeDTD(QString("<!DOCTYPE %1>").arg(m_pDoc->m_sDocType));
+    writer.writeStartElement(m_pDoc->m_sRootTag);
+    writeXMLText(writer, "Type", m_pDoc->m_sType);
+    writeXMLText(writer, "VersionNumber", "V1.00");
+    writeXMLText(writer, "SerialNumber", m_pDoc->m_sSerial);
+    writeXMLText(writer, "Date", "Mon Oct 19 2026");
+    writeXMLText(writer, "Time", "08:00:00");
+
+    writer.writeStartElement("Adjustment");
+    writeXMLText(writer, "Chksum", "0x1234");
+    writer.writeStartElement("Sense");
+
+    if (m_pDoc->m_ChannelNames.isEmpty())
+        exportRanges(writer, m_pDoc->m_RangeLists[0]);
+    else
+        for (int i = 0; i < m_pDoc->m_ChannelNames.count(); i++)
+        {
+            writer.writeStartElement("Channel");
+            writeXMLText(writer, "Name", m_pDoc->m_ChannelNames.at(i));
+            exportRanges(writer, m_pDoc->m_RangeLists[i]);
+            writer.writeEndElement(); // Channel
+        }
+
+    writer.writeEndElement(); // Sense
+    writer.writeEndElement(); // Adjustment
+    writer.writeEndElement(); // root
+}
+
+
+static QString exportStream(cBenchDocument* bdoc)
+{
+    cBenchAdjXML adjXML(bdoc);
+    return adjXML.exportXMLString(-1); // 1 line, as the server sends it
+}
+
+
+static long readPeakKB() // VmHWM: peak resident set size of this process
+{
+    QFile f("/proc/self/status");
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+
+    QList<QByteArray> lines = f.readAll().split('\n');
+    for (int i = 0; i < lines.count(); i++)
+        if (lines.at(i).startsWith("VmHWM:"))
+            return lines.at(i).mid(6).trimmed().split(' ').at(0).toLong();
+    return -1;
+}
+
+
+static int runMode(const QString& mode, int loops)
+{
+    QList<cBenchDocument*> set = createFullSet();
+    bool dom = (mode == "dom");
+    long baseKB = readPeakKB();
+    QByteArray hash;
+    int bytes = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int n = 0; n < loops; n++)
+    {
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        bytes = 0;
+        for (int i = 0; i < set.count(); i++)
+        {
+            QString s = dom ? exportDom(set.at(i)) : exportStream(set.at(i));
+            QByteArray ba = s.toUtf8();
+            md5.addData(ba);
+            bytes += ba.size();
+        }
+        hash = md5.result().toHex();
+    }
+
+    qint64 ns = timer.nsecsElapsed();
+
+    // one line for the parent process: mode us/export peak-kB bytes hash
+    printf("%s %.1f %ld %d %s\n", mode.toLatin1().constData(), ns / 1000.0 / loops,
+           readPeakKB() - baseKB, bytes, hash.constData());
+
+    qDeleteAll(set);
+    return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int loops = 200;
+
+    if (args.count() > 2)
+        loops = args.at(2).toInt();
+    if (args.count() > 1)
+        return runMode(args.at(1), loops);
+
+    QStringList results;
+    QStringList modes = QStringList() << "dom" << "stream";
+
+    for (int i = 0; i < modes.count(); i++)
+    {
+        QProcess proc;
+        proc.start(app.applicationFilePath(), QStringList() << modes.at(i) << QString::number(loops));
+        if (!proc.waitForFinished(-1) || (proc.exitCode() != 0))
+        {
+            fprintf(stderr, "%s run failed\n", modes.at(i).toLatin1().constData());
+            return 1;
+        }
+        results.append(QString::fromLatin1(proc.readAllStandardOutput()).trimmed());
+    }
+
+    printf("full set: 8 channels, 88 ranges, 3 clamps, %d loops\n", loops);
+    printf("%-8s %14s %18s %10s\n", "mode", "us/full set", "peak delta [kB]", "bytes");
+
+    QList<QStringList> fields;
+    for (int i = 0; i < results.count(); i++)
+    {
+        fields.append(results.at(i).split(' '));
+        const QStringList& f = fields.last();
+        if (f.count() < 5)
+            return 1;
+        printf("%-8s %14s %18s %10s\n", f.at(0).toLatin1().constData(), f.at(1).toLatin1().constData(),
+               f.at(2).toLatin1().constData(), f.at(3).toLatin1().constData());
+    }
+
+    bool same = (fields.at(0).at(4) == fields.at(1).at(4));
+    printf("output %s\n", same ? "identical" : "DIFFERS");
+
+    return same ? 0 : 1;
+}
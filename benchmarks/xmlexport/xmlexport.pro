@@ -0,0 +1,43 @@
+TEMPLATE	= app
+LANGUAGE	= C++
+
+QT += core xml
+QT -= gui
+
+CONFIG	+= console release
+CONFIG	-= app_bundle
+
+TARGET = xmlexport-bench
+
+# the stream side is the server's own xml writer with its adjustment data
+INCLUDEPATH += ../..
+
+LIBS +=  -lSCPI
+LIBS +=  -lzerai2c
+LIBS +=  -lzeramisc
+LIBS +=  -lzeramath
+
+HEADERS	+= \
+    ../../adjxml.h \
+    ../../justdata.h \
+    ../../justnode.h \
+    ../../nodeaccumulator.h \
+    ../../atmel.h \
+    ../../sharedread.h \
+    ../../scpiconnection.h \
+    ../../scpidelegate.h \
+    ../../protonetcommand.h \
+    ../../parsedcommand.h
+
+SOURCES	+= \
+    main.cpp \
+    ../../adjxml.cpp \
+    ../../justdata.cpp \
+    ../../justnode.cpp \
+    ../../nodeaccumulator.cpp \
+    ../../atmel.cpp \
+    ../../sharedread.cpp \
+    ../../scpiconnection.cpp \
+    ../../scpidelegate.cpp \
+    ../../protonetcommand.cpp \
+    ../../parsedcommand.cpp
@@ -1,11 +1,12 @@
 #include <QDateTime>
+#include <QMutex>
 #include <QByteArray>
 #include <QDataStream>
-#include <QDomDocument>
-#include <QDomElement>
+#include <QHash>
 #include <QBuffer>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <syslog.h>
-#include "i2cutils.h"
 
 #include "clamp.h"
 #include "clampinterface.h"
@@ -19,9 +20,60 @@
 #include "senseinterface.h"
 #include "senserange.h"
 #include "clampjustdata.h"
+#include "clampmux.h"
 #include "protonetcommand.h"
+#include "parsedcommand.h"
+#include "jobinterface.h"
 
-cClamp::cClamp(cMT310S2dServer *server, QString channelName, quint8 ctrlChannel)
+// a clamp range's adjustment is based on the secondary current range its signal is measured with
+struct cClampRangeDescriptor
+{
+    SenseRange::cRangeDescriptor range;
+    const char* baseRange;
+};
+
+static constexpr cClampRangeDescriptor CL120ARanges[] =
+{
+    //  name       alias     avail urvalue   rejection  ovrejection adcrejection sel mmask                                     base range
+    { { "C100A",   "C100A",   true,   100.0,  2953735.0,  3692169.0,  8388607.0, 11, SenseSystem::modeAC | SenseSystem::Clamp }, "2V" },
+    { { "C50A",    "C50A",    true,    50.0,  2953735.0,  3692169.0,  8388607.0, 12, SenseSystem::modeAC | SenseSystem::Clamp }, "1V" },
+    { { "C10A",    "C10A",    true,    10.0,  2796203.0,  3495254.0,  8388607.0, 14, SenseSystem::modeAC | SenseSystem::Clamp }, "200mV" },
+    { { "C5A",     "C5A",     true,     5.0,  3495253.0,  4369066.0,  8388607.0, 15, SenseSystem::modeAC | SenseSystem::Clamp }, "100mV" },
+    { { "C1A",     "C1A",     true,     1.0,  2796203.0,  3495254.0,  8388607.0, 17, SenseSystem::modeAC | SenseSystem::Clamp }, "20mV" },
+    { { "C500mA",  "C500mA",  true,     0.5,  3495253.0,  4369066.0,  8388607.0, 18, SenseSystem::modeAC | SenseSystem::Clamp }, "10mV" },
+    { { "C100mA",  "C100mA",  true,     0.1,  2796203.0,  3495254.0,  8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp }, "2mV" },
+    { { "C50mA",   "C50mA",   true,    0.05,  1398101.0,  1747626.0,  8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp }, "2mV" },
+    { { "C10mA",   "C10mA",   true,    0.01,   279620.0,   349525.0,  8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp }, "2mV" },
+};
+
+static constexpr cClampRangeDescriptor CL300ARanges[] =
+{
+    //  name       alias     avail urvalue   rejection  ovrejection adcrejection sel mmask                                     base range
+    { { "C300A",   "C300A",   true,   300.0,  2097152.0,  2097152.0,  8388607.0, 11, SenseSystem::modeAC | SenseSystem::Clamp }, "5V" },
+    { { "C150A",   "C150A",   true,   150.0,  1772241.0,  2215302.0,  8388607.0, 12, SenseSystem::modeAC | SenseSystem::Clamp }, "2V" },
+    { { "C30A",    "C30A",    true,    30.0,  1772241.0,  2215302.0,  8388607.0, 14, SenseSystem::modeAC | SenseSystem::Clamp }, "500mV" },
+    { { "C15A",    "C15A",    true,    15.0,  1677722.0,  2097153.0,  8388607.0, 15, SenseSystem::modeAC | SenseSystem::Clamp }, "200mV" },
+    { { "C3A",     "C3A",     true,     3.0,  1677722.0,  2097153.0,  8388607.0, 17, SenseSystem::modeAC | SenseSystem::Clamp }, "50mV" },
+    { { "C1.5A",   "C1.5A",   true,     1.5,  1677722.0,  2097153.0,  8388607.0, 18, SenseSystem::modeAC | SenseSystem::Clamp }, "20mV" },
+    { { "C300mA",  "C300mA",  true,     0.3,  1677722.0,  2097153.0,  8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp }, "5mV" },
+    { { "C150mA",  "C150mA",  true,    0.15,  1677722.0,  2097153.0,  8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp }, "2mV" },
+};
+
+static constexpr cClampRangeDescriptor CL1000ARanges[] =
+{
+    //  name       alias     avail urvalue   rejection  ovrejection adcrejection sel mmask                                     base range
+    { { "C1000A",  "C1000A",  true,  1000.0,  2362988.0,  2362988.0,  8388607.0, 12, SenseSystem::modeAC | SenseSystem::Clamp }, "1V" },
+    { { "C300A",   "C300A",   true,   300.0,  1772241.0,  2215302.0,  8388607.0, 13, SenseSystem::modeAC | SenseSystem::Clamp }, "500mV" },
+    { { "C100A",   "C100A",   true,   100.0,  2796203.0,  3495254.0,  8388607.0, 15, SenseSystem::modeAC | SenseSystem::Clamp }, "100mV" },
+    { { "C30A",    "C30A",    true,    30.0,  1677722.0,  2097153.0,  8388607.0, 16, SenseSystem::modeAC | SenseSystem::Clamp }, "50mV" },
+    { { "C10A",    "C10A",    true,    10.0,  2796203.0,  3495254.0,  8388607.0, 18, SenseSystem::modeAC | SenseSystem::Clamp }, "10mV" },
+    { { "C3A",     "C3A",     true,     3.0,  1677722.0,  2097153.0,  8388607.0, 19, SenseSystem::modeAC | SenseSystem::Clamp }, "5mV" },
+    { { "C1A",     "C1A",     true,     1.0,  1118481.0,  1398109.0,  8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp }, "2mV" },
+    { { "C300mA",  "C300mA",  true,     0.3,   335544.0,   419430.0,  8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp }, "2mV" },
+};
+
+
+cClamp::cClamp(cMT310S2dServer *server, QString channelName, quint8 ctrlChannel, QByteArray image, quint16 chksum, bool fromFlash)
     :cAdjFlash(server->m_pI2CSettings->getDeviceNode(), server->m_pDebugSettings->getDebugLevel(), server->m_pI2CSettings->getI2CAdress(i2cSettings::clampflash)), cAdjXML(server->m_pDebugSettings->getDebugLevel()), m_pMyServer(server), m_sChannelName(channelName), m_nCtrlChannel(ctrlChannel)
 {
     m_pSCPIInterface = m_pMyServer->getSCPIInterface();
@@ -35,14 +87,16 @@ cClamp::cClamp(cMT310S2dServer *server, QString channelName, quint8 ctrlChannel)
 
     addSystAdjInterface(); // we have an interface at once after clamp was connected
 
-    quint8 type;
-    if ((type = readClampType()) != undefined) // we try to read the clamp's type
+    // the image was read by the clamp reader already, it is empty if the clamp's type is unknown
+    if (image.size() > 6)
     {
-        m_nType = type;
+        m_nType = (quint8) image.at(6);
         initClamp(m_nType); // and if it's a well known type we init the clamp
-        importAdjFlash();
+        m_nChecksum = chksum;
+        if (importAdjImage(image) && fromFlash)
+            m_ShadowImage = image; // so the first write only touches changed pages, a cached image is not trusted for that
+        addSenseInterface(); // our ranges are complete before the sense channel announces them
         addSense();
-        addSenseInterface();
         m_bSet = true;
     }
 }
@@ -63,8 +117,6 @@ cClamp::~cClamp()
                 ptr = m_RangeList.at(i);
                 delete ptr; // the cSenseRange objects will also remove their interfaces including that for adjustment data
             }
-
-        disconnect(this, SIGNAL(cmdExecutionDone(cProtonetCommand*)), m_pMyServer, SLOT(sendAnswer(cProtonetCommand*)));
     }
 }
 
@@ -91,39 +143,39 @@ void cClamp::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     switch (cmdCode)
     {
     case clamp::cmdSerial:
-        protoCmd->m_sOutput = m_ReadWriteSerial(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadWriteSerial(protoCmd->m_Parsed);
         break;
     case clamp::cmdVersion:
-        protoCmd->m_sOutput = m_ReadWriteVersion(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadWriteVersion(protoCmd->m_Parsed);
         break;
     case clamp::cmdType:
-        protoCmd->m_sOutput = m_ReadWriteType(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadWriteType(protoCmd->m_Parsed);
         break;
     case clamp::cmdName:
-        protoCmd->m_sOutput = m_ReadWriteName(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadWriteName(protoCmd->m_Parsed);
         break;
     case clamp::cmdFlashWrite:
-        protoCmd->m_sOutput = m_WriteFlash(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_WriteFlash(protoCmd->m_Parsed);
         break;
     case clamp::cmdFlashRead:
-        protoCmd->m_sOutput = m_ReadFlash(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadFlash(protoCmd->m_Parsed);
         break;
     case clamp::cmdChksum:
-        protoCmd->m_sOutput = m_ReadChksum(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadChksum(protoCmd->m_Parsed);
         break;
     case clamp::cmdXMLWrite:
-        protoCmd->m_sOutput = m_WriteXML(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_WriteXML(protoCmd->m_Parsed);
         break;
     case clamp::cmdXMLRead:
-        protoCmd->m_sOutput = m_ReadXML(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadXML(protoCmd->m_Parsed);
         break;
     case clamp::cmdStatAdjustment:
-        protoCmd->m_sOutput = m_ReadAdjStatus(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadAdjStatus(protoCmd->m_Parsed);
         break;
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
@@ -190,139 +242,58 @@ bool cClamp::importAdjData(QDataStream &stream)
 }
 
 
-QString cClamp::exportXMLString(int indent)
+void cClamp::exportXML(QXmlStreamWriter &writer)
 {
     QDateTime DateTime;
 
-    QString s = QString("ClampAdjustmentData");
-    QDomDocument justqdom (s);
-
-    QDomElement pcbtag = justqdom.createElement( "CLAMP" );
-    justqdom.appendChild( pcbtag );
+    writer.writeDTD("<!DOCTYPE ClampAdjustmentData>");
+    writer.writeStartElement("CLAMP");
 
-    QDomElement tag = justqdom.createElement( "Type" );
-    pcbtag.appendChild( tag );
-    QDomText t = justqdom.createTextNode(getClampName(m_nType));
-    tag.appendChild( t );
-
-    tag = justqdom.createElement( "VersionNumber" );
-    pcbtag.appendChild( tag );
-    t = justqdom.createTextNode(m_sVersion);
-    tag.appendChild( t );
-
-    tag = justqdom.createElement( "SerialNumber" );
-    pcbtag.appendChild( tag );
-    t = justqdom.createTextNode(m_sSerial);
-    tag.appendChild( t );
-
-    tag = justqdom.createElement( "Date" );
-    pcbtag.appendChild( tag );
+    writeXMLText(writer, "Type", getClampName(m_nType));
+    writeXMLText(writer, "VersionNumber", m_sVersion);
+    writeXMLText(writer, "SerialNumber", m_sSerial);
     QDate d=DateTime.currentDateTime().date();
-    t = justqdom.createTextNode(d.toString(Qt::TextDate));
-    tag.appendChild( t );
-
-    tag = justqdom.createElement( "Time" );
-    pcbtag.appendChild( tag );
+    writeXMLText(writer, "Date", d.toString(Qt::TextDate));
     QTime ti=DateTime.currentDateTime().time();
-    t = justqdom.createTextNode(ti.toString(Qt::TextDate));
-    tag.appendChild( t );
+    writeXMLText(writer, "Time", ti.toString(Qt::TextDate));
 
-    QDomElement adjtag = justqdom.createElement( "Adjustment" );
-    pcbtag.appendChild( adjtag );
+    writer.writeStartElement("Adjustment");
+    writeXMLText(writer, "Chksum", QString("0x%1").arg(m_nChecksum,0,16));
 
-    QDomElement chksumtag = justqdom.createElement("Chksum");
-    adjtag.appendChild(chksumtag);
-    t = justqdom.createTextNode(QString("0x%1").arg(m_nChecksum,0,16));
-    chksumtag.appendChild(t);
-
-    QDomElement typeTag = justqdom.createElement( "Sense");
-    adjtag.appendChild(typeTag);
+    writer.writeStartElement("Sense");
 
     for (int j = 0; j < m_RangeList.count(); j++)
     {
         cSenseRange* rng = m_RangeList.at(j);
 
-        QDomElement rtag = justqdom.createElement( "Range" );
-        typeTag.appendChild( rtag );
-
-        QDomElement nametag = justqdom.createElement( "Name" );
-        rtag.appendChild(nametag);
-
-        t = justqdom.createTextNode(rng->getName());
-        nametag.appendChild( t );
-
-        QDomElement gpotag = justqdom.createElement( "Gain" );
-        rtag.appendChild(gpotag);
-        QDomElement tag = justqdom.createElement( "Status" );
-        QString jdata = rng->getJustData()->m_pGainCorrection->SerializeStatus();
-        t = justqdom.createTextNode(jdata);
-        gpotag.appendChild(tag);
-        tag.appendChild(t);
-        tag = justqdom.createElement( "Coefficients" );
-        gpotag.appendChild(tag);
-        jdata = rng->getJustData()->m_pGainCorrection->SerializeCoefficients();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
-        tag = justqdom.createElement( "Nodes" );
-        gpotag.appendChild(tag);
-        jdata = rng->getJustData()->m_pGainCorrection->SerializeNodes();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
-
-        gpotag = justqdom.createElement( "Phase" );
-        rtag.appendChild(gpotag);
-        tag = justqdom.createElement( "Status" );
-        jdata = rng->getJustData()->m_pPhaseCorrection->SerializeStatus();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
-        gpotag.appendChild(tag);
-        tag = justqdom.createElement( "Coefficients" );
-        gpotag.appendChild(tag);
-        jdata = rng->getJustData()->m_pPhaseCorrection->SerializeCoefficients();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
-        tag = justqdom.createElement( "Nodes" );
-        gpotag.appendChild(tag);
-        jdata = rng->getJustData()->m_pPhaseCorrection->SerializeNodes();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
-
-        gpotag = justqdom.createElement( "Offset" );
-        rtag.appendChild(gpotag);
-        tag = justqdom.createElement( "Status" );
-        jdata = rng->getJustData()->m_pOffsetCorrection->SerializeStatus();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
-        gpotag.appendChild(tag);
-        tag = justqdom.createElement( "Coefficients" );
-        gpotag.appendChild(tag);
-        jdata = rng->getJustData()->m_pOffsetCorrection->SerializeCoefficients();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
-        tag = justqdom.createElement( "Nodes" );
-        gpotag.appendChild(tag);
-        jdata = rng->getJustData()->m_pOffsetCorrection->SerializeNodes();
-        t = justqdom.createTextNode(jdata);
-        tag.appendChild(t);
+        writer.writeStartElement("Range");
+        writeXMLText(writer, "Name", rng->getName());
+        writeXMLCorrection(writer, "Gain", rng->getJustData()->m_pGainCorrection);
+        writeXMLCorrection(writer, "Phase", rng->getJustData()->m_pPhaseCorrection);
+        writeXMLCorrection(writer, "Offset", rng->getJustData()->m_pOffsetCorrection);
+        writer.writeEndElement(); // Range
     }
 
-    return justqdom.toString(indent);
+    writer.writeEndElement(); // Sense
+    writer.writeEndElement(); // Adjustment
+    writer.writeEndElement(); // CLAMP
 }
 
 
-bool cClamp::importXMLDocument(QDomDocument *qdomdoc, bool ignoreType)
+bool cClamp::importXMLString(QString &xml, bool ignoreType)
 {
-    QDateTime DateTime;
-    QDomDocumentType TheDocType = qdomdoc->doctype ();
+    QXmlStreamReader reader(xml);
+    return importXML(reader, ignoreType);
+}
 
-    if  (TheDocType.name() != QString("ClampAdjustmentData"))
-    {
-        if DEBUG1 syslog(LOG_ERR,"justdata import, wrong xml documentype\n");
-        return false;
-    }
 
-    QDomElement rootElem = qdomdoc->documentElement();
-    QDomNodeList nl = rootElem.childNodes();
+bool cClamp::importXML(QXmlStreamReader &reader, bool ignoreType)
+{
+    QList<cAdjXMLCorrection> stage;
+    QString serial, version;
+
+    if (!readXMLDocType(reader, "ClampAdjustmentData"))
+        return false;
 
     bool TypeOK = false;
     bool VersionNrOK = false;
@@ -330,25 +301,18 @@ bool cClamp::importXMLDocument(QDomDocument *qdomdoc, bool ignoreType)
     bool DateOK = false;
     bool TimeOK = false;
 
-    for (int i = 0; i < nl.length() ; i++)
+    while (reader.readNextStartElement())
     {
-        QDomNode qdNode = nl.item(i);
-        QDomElement qdElem = qdNode.toElement();
-        if ( qdElem.isNull() )
-        {
-            if DEBUG1 syslog(LOG_ERR,"justdata import, format error in xml file\n");
-            return false;
-        }
-
-        QString tName = qdElem.tagName();
+        QString tName = reader.name().toString();
 
         if (tName == "Type")
         {
+            QString type = reader.readElementText();
             if (ignoreType)
                 TypeOK = true;
             else
             {
-                if ( !(TypeOK = (qdElem.text() == getClampName(m_nType))))
+                if ( !(TypeOK = (type == getClampName(m_nType))))
                 {
                     if DEBUG1 syslog(LOG_ERR,"justdata import, wrong type information in xml file\n");
                     return false;
@@ -361,7 +325,7 @@ bool cClamp::importXMLDocument(QDomDocument *qdomdoc, bool ignoreType)
         if (tName == "SerialNumber")
         {
             SerialNrOK = true;
-            m_sSerial = qdElem.text();
+            serial = reader.readElementText();
         }
 
         else
@@ -369,15 +333,14 @@ bool cClamp::importXMLDocument(QDomDocument *qdomdoc, bool ignoreType)
         if (tName == "VersionNumber")
         {
            VersionNrOK = true;
-           m_sVersion = qdElem.text();
+           version = reader.readElementText();
         }
 
         else
 
         if (tName=="Date")
         {
-            QDate d = QDate::fromString(qdElem.text(),Qt::TextDate);
-            DateTime.setDate(d);
+            reader.skipCurrentElement();
             DateOK = true;
         }
 
@@ -385,8 +348,7 @@ bool cClamp::importXMLDocument(QDomDocument *qdomdoc, bool ignoreType)
 
         if (tName=="Time")
         {
-            QTime t = QTime::fromString(qdElem.text(),Qt::TextDate);
-            DateTime.setTime(t);
+            reader.skipCurrentElement();
             TimeOK = true;
         }
 
@@ -394,97 +356,46 @@ bool cClamp::importXMLDocument(QDomDocument *qdomdoc, bool ignoreType)
 
         if (tName == "Adjustment")
         {
-            if ( TypeOK && VersionNrOK && SerialNrOK && DateOK && TimeOK)
+            if ( !(TypeOK && VersionNrOK && SerialNrOK && DateOK && TimeOK) )
             {
-                bool done = false;
+                if DEBUG1 syslog(LOG_ERR,"justdata import, xml file contains strange data\n");
+                return false;
+            }
 
-                QDomNodeList adjChildNl = qdElem.childNodes();
-                for (qint32 j = 0; j < adjChildNl.length(); j++)
+            bool done = false;
+
+            while (reader.readNextStartElement())
+            {
+                if (reader.name() == "Sense") // we look for the sense entry
                 {
-                    qdNode = adjChildNl.item(j);
+                    done = true;
 
-                    qDebug() << qdNode.toElement().tagName();
-                    if (qdNode.toElement().tagName() == "Sense") // we look for the sense entry
+                    while (reader.readNextStartElement()) // we iterate over all ranges
                     {
-                        done = true;
-
-                        QDomNodeList sensNl = qdNode.childNodes(); // we iterate over all ranges
-                        for (qint32 j = 0; j < sensNl.length(); j++)
+                        if (reader.name() == "Range")
                         {
-                            cSenseRange* rngPtr;
-                            QString Name;
+                            QString rngName;
+                            QList<cAdjXMLCorrection> corrList;
 
-                            QDomNode RangeJustNode = sensNl.item(j);
-                            qdElem = RangeJustNode.toElement();
-                            QString tName = qdElem.tagName();
-                            qDebug() << tName;
-
-                            if (tName == "Range")
+                            if (readXMLRange(reader, rngName, corrList))
                             {
-                                QDomNodeList rngJustNl = RangeJustNode.childNodes();
-                                for (qint32 k = 0; k < rngJustNl.length(); k++)
-                                {
-                                    QDomNode RangeJustNode = rngJustNl.item(k);
-
-                                    qdElem = RangeJustNode.toElement();
-                                    tName = qdElem.tagName();
-                                    qDebug() << tName;
-
-                                    if (tName == "Name")
-                                    {
-                                        Name = qdElem.text();
-                                        qDebug() << Name;
-                                        rngPtr = getRange(Name);
-                                    }
-
-                                    cJustData* pJustData = 0;
-
-                                    if (rngPtr != 0)
-                                    {
-                                        if (tName == "Gain")
-                                            pJustData = rngPtr->getJustData()->m_pGainCorrection;
-
-                                        if (tName == "Phase")
-                                            pJustData = rngPtr->getJustData()->m_pPhaseCorrection;
-
-                                        if (tName == "Offset")
-                                            pJustData = rngPtr->getJustData()->m_pOffsetCorrection;
-                                    }
-
-                                    if (pJustData)
-                                    {
-                                        QDomNodeList jdataNl = RangeJustNode.childNodes();
-                                        for (qint32 k = 0; k < jdataNl.count(); k++)
-                                        {
-                                            QDomNode jTypeNode = jdataNl.item(k);
-                                            QString jTypeName = jTypeNode.toElement().tagName();
-                                            QString jdata = jTypeNode.toElement().text();
-
-                                            if (jTypeName == "Status")
-                                                pJustData->DeserializeStatus(jdata);
-
-                                            if (jTypeName == "Coefficients")
-                                                pJustData->DeserializeCoefficients(jdata);
-
-                                            if (jTypeName == "Nodes")
-                                                pJustData->DeserializeNodes(jdata);
-                                        }
-                                    }
-                                }
+                                cSenseRange* rngPtr = getRange(rngName);
+                                if (rngPtr != 0)
+                                    stageXMLRange(rngPtr->getJustData(), corrList, stage);
                             }
                         }
+                        else
+                            reader.skipCurrentElement();
                     }
                 }
-
-                if (!done)
-                    return done;
-            }
-            else
-            {
-                if DEBUG1 syslog(LOG_ERR,"justdata import, xml file contains strange data\n");
-                return false;
+                else
+                    reader.skipCurrentElement();
             }
+
+            if (!done)
+                return done;
         }
+
         else
         {
             if DEBUG1 syslog(LOG_ERR,"justdata import, xml file contains strange data\n");
@@ -492,133 +403,165 @@ bool cClamp::importXMLDocument(QDomDocument *qdomdoc, bool ignoreType)
         }
     }
 
+    if (reader.hasError())
+    {
+        if DEBUG1 syslog(LOG_ERR,"justdata import, format error in xml file\n");
+        return false;
+    }
+
+    // the document was ok, now we take over its data
+    if (SerialNrOK)
+        m_sSerial = serial;
+    if (VersionNrOK)
+        m_sVersion = version;
+    commitXMLCorrections(stage);
+
     return true;
 }
 
 
-bool cClamp::importXMLDocument(QDomDocument *qdomdoc)
+bool cClamp::importXML(QXmlStreamReader &reader)
 {
-    return importXMLDocument(qdomdoc, false);
+    return importXML(reader, false);
 }
 
 
 void cClamp::setI2CMux()
 {
-    ushort I2CAdress;
-    uchar outpBuf[1]; // 1 adr byte, 1 byte data = mux code
+    m_pMyServer->m_pClampInterface->getClampMux()->select(m_nCtrlChannel); // the mux knows whether it must switch
+}
+
+
+bool cClamp::isFlashJobPending()
+{
+    return m_pMyServer->m_pClampInterface->isFlashJobPending();
+}
+
 
-    I2CAdress = m_pMyServer->m_pI2CSettings->getI2CAdress(i2cSettings::flashmux);
-    outpBuf[0] = (m_nCtrlChannel - 4) | 8; // .... hardware ????
+QString cClamp::writeFlashJob()
+{
+    QStringList serialList;
+    serialList.append(m_sSerial);
+    return QString("%1").arg(m_pMyServer->m_pJobInterface->addJob(new cClampImportJob(m_pMyServer->m_pClampInterface, serialList)));
+}
 
-    struct i2c_msg Msgs = {addr: I2CAdress, flags: 0, len: 1, buf:  outpBuf }; // 1 message
-    struct i2c_rdwr_ioctl_data MuxData = { msgs: &(Msgs), nmsgs: 1 };
 
-    I2CTransfer(m_sDeviceNode, I2CAdress, 0, &MuxData);
+bool cClamp::writeFlashPages(int n)
+{
+    QMutex* lock = m_pMyServer->m_pClampInterface->getClampMux()->getLock();
+
+    // the clamp reader might read a whole image just now, we don't wait for it in the main thread
+    if (!lock->tryLock())
+        return true; // nothing written, the job tries again in its next step
+
+    bool ok = cAdjFlash::writeFlashPages(n);
+    lock->unlock();
+    return ok;
+}
+
+
+QString cClamp::getCacheKey()
+{
+    return cacheKey(m_sSerial);
+}
+
+
+QString cClamp::readSerial(QByteArray &header)
+{
+    QDataStream stream(&header, QIODevice::ReadOnly);
+    stream.setVersion(QDataStream::Qt_5_4);
+
+    quint8 type;
+    quint32 flags;
+    QString name, version, serial;
+
+    stream.skipRawData(6);
+    stream >> type >> flags >> name >> version >> serial;
+
+    if (stream.status() != QDataStream::Ok)
+        return QString();
+
+    return serial;
+}
+
+
+QString cClamp::cacheKey(QString serial)
+{
+    // readCache compares the header we read with the cached one, the header includes the serial
+    // number. so a clamp with equal count and chksum but different serial will never get this image
+    if (serial.isEmpty())
+        return QString();
+
+    return QString("clamp-%1").arg(QString(serial.toUtf8().toHex())); // any serial makes a valid file name
 }
 
 
 quint8 cClamp::getAdjustmentStatus()
 {
-    quint8 stat = 255;
+    // our ranges keep count of their not justified coefficients, so we don't look at coefficients here
+    int notAdjusted = 0;
     for (int i = 0; i < m_RangeList.count(); i++)
-        stat &= m_RangeList.at(i)->getAdjustmentStatus();
+        notAdjusted += m_RangeList.at(i)->getNotAdjustedCount();
 
-    if ((stat & JustData::Justified)== 0)
+    if (notAdjusted != 0)
         return Adjustment::notAdjusted;
     else
         return Adjustment::adjusted;
 }
 
 
-quint8 cClamp::readClampType()
+bool cClamp::readClampImage(QByteArray &ba, quint8 &type)
 {
-    QByteArray ba;
-    setI2CMux();
-    if (readFlash(ba)) // flash data could be read with correct chksum
-    {
-        quint8 type;
-        QDataStream stream(&ba, QIODevice::ReadWrite);
-        stream.setVersion(QDataStream::Qt_5_4);
-        stream.skipRawData(6);
-        stream >> type;
-        return type;
-    }
-    else
-        return 0;
+    setI2CMux(); // the caller holds the mux lock
+
+    // the header tells us the clamp's type, we only read the whole image if we know the type
+    if (!readFlashHeader(ba, clamp::HeaderLength) || (ba.size() < 7))
+        return false;
+
+    type = (quint8) ba.at(6);
+    if ( (type == undefined) || (type >= anzCL) )
+        return false;
+
+    return readFlashImage(ba); // the type is part of the chksum, so it is verified with the image
 }
 
 
 void cClamp::initClamp(quint8 type)
 {
-    cClampJustData* clampJustData;
+    const cClampRangeDescriptor* descriptors;
+    int count;
 
     m_RangeList.clear(); // we must clear our list, maybe we wanted to redefine a clamp
+    m_RangeHash.clear();
     m_sName = getClampName(type);
 
     switch (type)
     {
     case CL120A:
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2V")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C100A",  "C100A", true, 100.0, 2953735.0, 3692169.0, 8388607.0, 11, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("1V")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,   "C50A",   "C50A", true,  50.0, 2953735.0, 3692169.0, 8388607.0, 12, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("200mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,   "C10A",   "C10A", true,  10.0, 2796203.0, 3495254.0, 8388607.0, 14, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("100mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,    "C5A",    "C5A", true,   5.0, 3495253.0, 4369066.0, 8388607.0, 15, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("20mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,    "C1A",    "C1A", true,   1.0, 2796203.0, 3495254.0, 8388607.0, 17, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("10mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface, "C500mA", "C500mA", true,   0.5, 3495253.0, 4369066.0, 8388607.0, 18, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface, "C100mA", "C100mA", true,   0.1, 2796203.0, 3495254.0, 8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C50mA",  "C50mA", true,  0.05, 1398101.0, 1747626.0, 8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C10mA",  "C10mA", true,  0.01,  279620.0,  349525.0, 8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-
+        descriptors = CL120ARanges;
+        count = sizeof(CL120ARanges) / sizeof(CL120ARanges[0]);
         break;
-
     case CL300A:
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("5V")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C300A",  "C300A", true, 300.0, 2097152.0, 2097152.0, 8388607.0, 11, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2V")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C150A",  "C150A", true, 150.0, 1772241.0, 2215302.0, 8388607.0, 12, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("500mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,   "C30A",   "C30A", true,  30.0, 1772241.0, 2215302.0, 8388607.0, 14, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("200mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,   "C15A",   "C15A", true,  15.0, 1677722.0, 2097153.0, 8388607.0, 15, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("50mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,    "C3A",    "C3A", true,   3.0, 1677722.0, 2097153.0, 8388607.0, 17, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("20mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C1.5A",  "C1.5A", true,   1.5, 1677722.0, 2097153.0, 8388607.0, 18, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("5mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface, "C300mA", "C300mA", true,   0.3, 1677722.0, 2097153.0, 8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface, "C150mA", "C150mA", true,  0.15, 1677722.0, 2097153.0, 8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-
+        descriptors = CL300ARanges;
+        count = sizeof(CL300ARanges) / sizeof(CL300ARanges[0]);
         break;
-
     case CL1000A:
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("1V")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface, "C1000A", "C1000A", true, 1000.0, 2362988.0, 2362988.0, 8388607.0, 12, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("500mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C300A",  "C300A", true,  300.0, 1772241.0, 2215302.0, 8388607.0, 13, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("100mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,  "C100A",  "C100A", true,  100.0, 2796203.0, 3495254.0, 8388607.0, 15, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("50mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,   "C30A",   "C30A", true,   30.0, 1677722.0, 2097153.0, 8388607.0, 16, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("10mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,   "C10A",   "C10A", true,   10.0, 2796203.0, 3495254.0, 8388607.0, 18, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("5mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,    "C3A",    "C3A", true,    3.0, 1677722.0, 2097153.0, 8388607.0, 19, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface,    "C1A",    "C1A", true,    1.0, 1118481.0, 1398109.0, 8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-        clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString("2mV")));
-        m_RangeList.append(new cSenseRange(m_pSCPIInterface, "C300mA", "C300mA", true,    0.3,  335544.0,  419430.0, 8388607.0, 20, SenseSystem::modeAC | SenseSystem::Clamp, clampJustData));
-
+        descriptors = CL1000ARanges;
+        count = sizeof(CL1000ARanges) / sizeof(CL1000ARanges[0]);
         break;
+    default:
+        descriptors = 0;
+        count = 0;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        cClampJustData* clampJustData = new cClampJustData(m_pSCPIInterface, m_pMyServer->m_pSenseInterface->getRange(m_sChannelName, QString(descriptors[i].baseRange)));
+        m_RangeList.append(new cSenseRange(m_pSCPIInterface, &descriptors[i].range, clampJustData));
     }
+
+    for (int i = 0; i < m_RangeList.count(); i++)
+        m_RangeHash[m_RangeList.at(i)->getName()] = m_RangeList.at(i);
 }
 
 
@@ -658,7 +601,6 @@ void cClamp::addSenseInterface()
     {
         cSenseRange* p_Range = m_RangeList.at(i);
         p_Range->initSCPIConnection(QString("SENSE:%1").arg(m_sChannelName));
-        connect(p_Range, SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
     }
 }
 
@@ -709,30 +651,18 @@ void cClamp::addSystAdjInterface()
     delegate = new cSCPIDelegate(cmdParent, "ADJUSTMENT", SCPI::isQuery, m_pSCPIInterface, clamp::cmdStatAdjustment);
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-
-    connect(this, SIGNAL(cmdExecutionDone(cProtonetCommand*)), m_pMyServer, SLOT(sendAnswer(cProtonetCommand*)));
 }
 
 
 cSenseRange* cClamp::getRange(QString name)
 {
-    cSenseRange* rng = 0;
-    for (int i = 0; i < m_RangeList.count(); i++)
-    {
-        if (m_RangeList.at(i)->getName() == name)
-        {
-            rng = m_RangeList.at(i);
-            break;
-        }
-    }
-    return rng;
+    return m_RangeHash.value(name, 0);
 }
 
 
-QString cClamp::m_ReadWriteSerial(QString& sInput)
+QString cClamp::m_ReadWriteSerial(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd =sInput;
 
     if (cmd.isQuery())
     {
@@ -742,7 +672,7 @@ QString cClamp::m_ReadWriteSerial(QString& sInput)
     {
         if (cmd.isCommand(1))
         {
-            QString serial = cmd.getParam(0);
+            QString serial = cmd.getParam(0).toString();
             if (serial.length() <= 10)
             {
                 m_sSerial = serial;
@@ -759,10 +689,9 @@ QString cClamp::m_ReadWriteSerial(QString& sInput)
 }
 
 
-QString cClamp::m_ReadWriteVersion(QString &sInput)
+QString cClamp::m_ReadWriteVersion(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd =sInput;
 
     if (cmd.isQuery())
     {
@@ -772,7 +701,7 @@ QString cClamp::m_ReadWriteVersion(QString &sInput)
     {
         if (cmd.isCommand(1))
         {
-            QString version = cmd.getParam(0);
+            QString version = cmd.getParam(0).toString();
             if (version.length() == 4)
             {
                 m_sVersion = version;
@@ -789,10 +718,9 @@ QString cClamp::m_ReadWriteVersion(QString &sInput)
 }
 
 
-QString cClamp::m_ReadWriteType(QString& sInput)
+QString cClamp::m_ReadWriteType(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd =sInput;
 
     if (cmd.isQuery())
     {
@@ -805,6 +733,11 @@ QString cClamp::m_ReadWriteType(QString& sInput)
             quint8 type;
             type = cmd.getParam(0).toInt();
 
+            if (isFlashJobPending())
+                answer = SCPI::scpiAnswer[SCPI::busy];
+
+            else
+
             if ( (type > undefined) && (type < anzCL))
             {
                 if (m_bSet)
@@ -818,14 +751,10 @@ QString cClamp::m_ReadWriteType(QString& sInput)
 
                 m_nType = type;
                 initClamp(type);
-                if (exportAdjFlash())
-                {
-                    addSense();
-                    addSenseInterface();
-                    answer = SCPI::scpiAnswer[SCPI::ack];
-                }
-                else
-                    answer = SCPI::scpiAnswer[SCPI::errexec];
+                addSense();
+                addSenseInterface();
+                m_bSet = true;
+                answer = writeFlashJob(); // the new type is written to flash by a job
             }
 
             else
@@ -840,10 +769,9 @@ QString cClamp::m_ReadWriteType(QString& sInput)
 }
 
 
-QString cClamp::m_ReadWriteName(QString& sInput)
+QString cClamp::m_ReadWriteName(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd =sInput;
 
     if (cmd.isQuery())
     {
@@ -853,7 +781,7 @@ QString cClamp::m_ReadWriteName(QString& sInput)
     {
         if (cmd.isCommand(1))
         {
-            QString name = cmd.getParam(0);
+            QString name = cmd.getParam(0).toString();
             if (name.length() < 21)
             {
                 m_sName = name;
@@ -870,17 +798,16 @@ QString cClamp::m_ReadWriteName(QString& sInput)
 }
 
 
-QString cClamp::m_WriteFlash(QString& sInput)
+QString cClamp::m_WriteFlash(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd = sInput;
 
-    if (cmd.isCommand(1) && (cmd.getParam(0) == ""))
+    if (cmd.isCommand(1) && cmd.getParam(0).isEmpty())
     {
-        if (exportAdjFlash())
-            answer = SCPI::scpiAnswer[SCPI::ack];
+        if (isFlashJobPending())
+            answer = SCPI::scpiAnswer[SCPI::busy];
         else
-            answer = SCPI::scpiAnswer[SCPI::errexec];
+            answer = writeFlashJob();
     }
 
     else
@@ -890,20 +817,32 @@ QString cClamp::m_WriteFlash(QString& sInput)
 }
 
 
-QString cClamp::m_ReadFlash(QString& sInput)
+QString cClamp::m_ReadFlash(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd = sInput;
 
-    if (cmd.isCommand(1) && (cmd.getParam(0) == ""))
+    if (cmd.isCommand(1) && cmd.getParam(0).isEmpty())
     {
-        if (readClampType() == m_nType) // we first look whether the type matches
+        QByteArray image;
+        quint8 type;
+        QMutex* lock = m_pMyServer->m_pClampInterface->getClampMux()->getLock();
+
+        // a half written image or the clamp reader using the mux, we don't wait in the main thread
+        if (isFlashJobPending() || !lock->tryLock())
+            answer = SCPI::scpiAnswer[SCPI::busy];
+        else
         {
-            importAdjFlash();
-            answer = SCPI::scpiAnswer[SCPI::ack];
+            bool ok = readClampImage(image, type) && (type == m_nType); // we first look whether the type matches
+            lock->unlock();
+
+            if (ok)
+            {
+                importAdjImage(image);
+                answer = SCPI::scpiAnswer[SCPI::ack];
+            }
+            else
+                answer = SCPI::scpiAnswer[SCPI::errexec];
         }
-        else
-            answer = SCPI::scpiAnswer[SCPI::errexec];
     }
 
     else
@@ -913,10 +852,9 @@ QString cClamp::m_ReadFlash(QString& sInput)
 }
 
 
-QString cClamp::m_ReadChksum(QString& sInput)
+QString cClamp::m_ReadChksum(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
@@ -931,14 +869,13 @@ QString cClamp::m_ReadChksum(QString& sInput)
 }
 
 
-QString cClamp::m_WriteXML(QString &sInput)
+QString cClamp::m_WriteXML(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isCommand(1))
     {
-        QString filename = cmd.getParam(0);
+        QString filename = cmd.getParam(0).toString();
         if (exportAdjXML(filename))
             answer = SCPI::scpiAnswer[SCPI::ack];
         else
@@ -952,14 +889,13 @@ QString cClamp::m_WriteXML(QString &sInput)
 }
 
 
-QString cClamp::m_ReadXML(QString &sInput)
+QString cClamp::m_ReadXML(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isCommand(1))
     {
-        QString filename = cmd.getParam(0);
+        QString filename = cmd.getParam(0).toString();
         if (importAdjXML(filename))
             answer = SCPI::scpiAnswer[SCPI::ack];
         else
@@ -973,10 +909,9 @@ QString cClamp::m_ReadXML(QString &sInput)
 }
 
 
-QString cClamp::m_ReadAdjStatus(QString &sInput)
+QString cClamp::m_ReadAdjStatus(const cParsedCommand &cmd)
 {
     QString answer;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
@@ -2,6 +2,7 @@
 #define CLAMP_H
 
 #include <QList>
+#include <QHash>
 #include <QDataStream>
 #include <QDateTime>
 
@@ -25,6 +26,7 @@ namespace clamp
         cmdStatAdjustment
     };
 
+    const int HeaderLength = 256; // we read that much in advance, it holds type, name, version and serial
 }
 
 
@@ -32,38 +34,46 @@ enum clamps { undefined, CL120A, CL300A, CL1000A , anzCL};
 
 class cMT310S2dServer;
 class cSenseRange;
-class QDomDocument;
+class cParsedCommand;
 
 class cClamp: public cAdjFlash, public cAdjXML, public cSCPIConnection
 {
 public:
     cClamp(){m_pMyServer = 0;}
-    cClamp(cMT310S2dServer *server, QString channelName, quint8 ctrlChannel);
+    cClamp(cMT310S2dServer *server, QString channelName, quint8 ctrlChannel, QByteArray image, quint16 chksum, bool fromFlash); // image and its verified chksum as read by the clamp reader
     virtual ~cClamp();
+    virtual bool writeFlashPages(int n);
+    virtual bool isFlashJobPending(); // clamp flash jobs are counted by the clamp interface
     virtual quint8 getAdjustmentStatus();
     virtual void initSCPIConnection(QString);
     QString getChannelName();
     QString getSerial();
-    virtual QString exportXMLString(int indent = 1);
-    virtual bool importXMLDocument(QDomDocument *qdomdoc, bool ignoreType);
+    bool importXMLString(QString& xml, bool ignoreType); // ignoreType: we only want to know serial and version
+    static QString readSerial(QByteArray& header); // empty if header is too short
+    static QString cacheKey(QString serial); // clamp images are cached by serial number
 
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
 protected:
     QList<cSenseRange*> m_RangeList;
+    QHash<QString, cSenseRange*> m_RangeHash; // name -> range
 
     virtual void exportAdjData(QDataStream& stream);
     virtual bool importAdjData(QDataStream& stream);
-    virtual bool importXMLDocument(QDomDocument* qdomdoc);
+    virtual void exportXML(QXmlStreamWriter& writer);
+    virtual bool importXML(QXmlStreamReader& reader);
+    bool importXML(QXmlStreamReader& reader, bool ignoreType);
 
     virtual void setI2CMux();
-    virtual quint8 readClampType();
+    virtual QString getCacheKey();
+    bool readClampImage(QByteArray& ba, quint8& type); // header first, the whole image only for a known type, caller holds the mux lock
     virtual void initClamp(quint8 type);
     virtual QString getClampName(quint8 type);
     void addSense();
     void addSenseInterface();
     void addSystAdjInterface();
+    QString writeFlashJob(); // starts a job writing our flash and returns its id
 
 private:
     cMT310S2dServer* m_pMyServer;
@@ -79,16 +89,16 @@ private:
 
     cSenseRange* getRange(QString name);
 
-    QString m_ReadWriteSerial(QString &sInput);
-    QString m_ReadWriteVersion(QString &sInput);
-    QString m_ReadWriteType(QString &sInput);
-    QString m_ReadWriteName(QString &sInput);
-    QString m_WriteFlash(QString &sInput);
-    QString m_ReadFlash(QString &sInput);
-    QString m_ReadChksum(QString &sInput);
-    QString m_WriteXML(QString &sInput);
-    QString m_ReadXML(QString &sInput);
-    QString m_ReadAdjStatus(QString &sInput);
+    QString m_ReadWriteSerial(const cParsedCommand& cmd);
+    QString m_ReadWriteVersion(const cParsedCommand& cmd);
+    QString m_ReadWriteType(const cParsedCommand& cmd);
+    QString m_ReadWriteName(const cParsedCommand& cmd);
+    QString m_WriteFlash(const cParsedCommand& cmd);
+    QString m_ReadFlash(const cParsedCommand& cmd);
+    QString m_ReadChksum(const cParsedCommand& cmd);
+    QString m_WriteXML(const cParsedCommand& cmd);
+    QString m_ReadXML(const cParsedCommand& cmd);
+    QString m_ReadAdjStatus(const cParsedCommand& cmd);
 
 };
 
@@ -1,4 +1,5 @@
-#include <QDomDocument>
+
+#include <syslog.h>
 
 #include "clampinterface.h"
 #include "mt310s2d.h"
@@ -7,13 +8,39 @@
 #include "clamp.h"
 #include "senseinterface.h"
 #include "protonetcommand.h"
+#include "parsedcommand.h"
+#include "jobinterface.h"
+#include "clampreader.h"
+#include "clampmux.h"
+#include "i2csettings.h"
+#include "debugsettings.h"
 
 
 cClampInterface::cClampInterface(cMT310S2dServer *server, cATMEL *controler)
     :m_pMyServer(server), m_pControler(controler)
 {
     m_nClampStatus = 0;
+    m_nFlashJobs = 0;
     m_pSCPIInterface = m_pMyServer->getSCPIInterface();
+
+    m_pClampMux = new cClampMux(m_pMyServer->m_pI2CSettings->getDeviceNode(), m_pMyServer->m_pI2CSettings->getI2CAdress(i2cSettings::flashmux));
+    m_pClampReader = new cClampReader(m_pMyServer->m_pI2CSettings->getDeviceNode(),
+                                      m_pMyServer->m_pDebugSettings->getDebugLevel(),
+                                      m_pMyServer->m_pI2CSettings->getI2CAdress(i2cSettings::clampflash),
+                                      m_pClampMux);
+    m_pClampReader->moveToThread(&m_ReaderThread);
+    connect(this, SIGNAL(readClamp(int,QString,quint32)), m_pClampReader, SLOT(readClamp(int,QString,quint32)));
+    connect(m_pClampReader, SIGNAL(clampRead(int,QByteArray,quint16,bool,quint32,qint64)), this, SLOT(clampRead(int,QByteArray,quint16,bool,quint32,qint64)));
+    connect(&m_ReaderThread, SIGNAL(finished()), m_pClampReader, SLOT(deleteLater()));
+    m_ReaderThread.start();
+}
+
+
+cClampInterface::~cClampInterface()
+{
+    m_ReaderThread.quit();
+    m_ReaderThread.wait(); // a running read finishes first, the reader is deleted then
+    delete m_pClampMux;
 }
 
 
@@ -33,6 +60,18 @@ void cClampInterface::initSCPIConnection(QString leadingNodes)
     delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:CLAMP").arg(leadingNodes),"XML",SCPI::isQuery | SCPI::isCmdwP, m_pSCPIInterface, ClampSystem::cmdClampImportExport);
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:CLAMP:XML").arg(leadingNodes),"BEGIN",SCPI::isCmd, m_pSCPIInterface, ClampSystem::cmdClampXMLBegin);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:CLAMP:XML").arg(leadingNodes),"APPEND",SCPI::isCmdwP, m_pSCPIInterface, ClampSystem::cmdClampXMLAppend);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:CLAMP:XML").arg(leadingNodes),"COMMIT",SCPI::isCmd, m_pSCPIInterface, ClampSystem::cmdClampXMLCommit);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    delegate = new cSCPIDelegate(QString("%1SYSTEM:CLAMP:MUX").arg(leadingNodes),"STATISTIC",SCPI::isQuery, m_pSCPIInterface, ClampSystem::cmdClampMuxStatistic);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
 }
 
 
@@ -50,24 +89,27 @@ void cClampInterface::actualizeClampStatus()
             bmask = 1 << i;
             if ((clChange & bmask) > 0)
             {
+                m_ReadSeqHash[i]++; // an image that is still on its way is outdated now
+
                 if ((m_nClampStatus & bmask) == 0)
                 {
                     // a clamp is connected perhaps it was actually connected
+                    // we let the reader fetch its image, the clamp is built when it's there
                     m_nClampStatus |= bmask;
-                    QString s = m_pMyServer->m_pSenseInterface->getChannelSystemName(i+1);
-                    clampHash[i] = new cClamp(m_pMyServer, s, i+1);
-                    addChannel(s);
+                    m_PlugTimerHash[i].start();
+                    emit readClamp(i+1, m_pMyServer->m_pSenseInterface->getChannelSystemName(i+1), m_ReadSeqHash[i]);
                 }
                 else
                 {
                     // a clamp is not connected
+                    m_nClampStatus &= (~bmask);
                     if (clampHash.contains(i))
                     {   // if we already have a clamp on this place it was actually disconnected
-                        m_nClampStatus &= (~bmask);
                         cClamp* clamp;
                         clamp = clampHash.take(i);
                         removeChannel(clamp->getChannelName());
                         delete clamp;
+                        emit clampsChanged();
                     }
                 }
             }
@@ -76,6 +118,31 @@ void cClampInterface::actualizeClampStatus()
 }
 
 
+void cClampInterface::clampRead(int ctrlChannel, QByteArray image, quint16 chksum, bool fromFlash, quint32 seq, qint64 ms)
+{
+    int i = ctrlChannel - 1;
+
+    // the clamp might have been removed or replaced while we were reading
+    if ( (seq != m_ReadSeqHash.value(i)) || ((m_nClampStatus & (1 << i)) == 0) || clampHash.contains(i) )
+        return;
+
+    // we build the clamp with its ranges and interfaces at once, so clients only see complete clamps
+    QString s = m_pMyServer->m_pSenseInterface->getChannelSystemName(ctrlChannel);
+    clampHash[i] = new cClamp(m_pMyServer, s, ctrlChannel, image, chksum, fromFlash);
+    addChannel(s);
+    emit clampsChanged();
+
+    if (m_pMyServer->m_pDebugSettings->getDebugLevel() & 2)
+        syslog(LOG_INFO,"clamp on %s ready after %lld ms, %lld ms reading\n", s.toLatin1().data(), m_PlugTimerHash[i].elapsed(), ms);
+}
+
+
+cClampMux *cClampInterface::getClampMux()
+{
+    return m_pClampMux;
+}
+
+
 void cClampInterface::addChannel(QString channel)
 {
     m_ClampChannelList.append(channel);
@@ -92,24 +159,34 @@ void cClampInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     switch (cmdCode)
     {
     case ClampSystem::cmdClampChannelCat:
-        protoCmd->m_sOutput = m_ReadClampChannelCatalog(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadClampChannelCatalog(protoCmd->m_Parsed);
         break;
     case ClampSystem::cmdClampWrite:
-        protoCmd->m_sOutput = m_WriteAllClamps(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_WriteAllClamps(protoCmd->m_Parsed);
         break;
     case ClampSystem::cmdClampImportExport:
-        protoCmd->m_sOutput = m_ImportExportAllClamps(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ImportExportAllClamps(protoCmd->m_Parsed);
+        break;
+    case ClampSystem::cmdClampXMLBegin:
+        protoCmd->m_sOutput = m_XMLUploadBegin(protoCmd);
+        break;
+    case ClampSystem::cmdClampXMLAppend:
+        protoCmd->m_sOutput = m_XMLUploadAppend(protoCmd);
+        break;
+    case ClampSystem::cmdClampXMLCommit:
+        protoCmd->m_sOutput = m_XMLUploadCommit(protoCmd);
+        break;
+    case ClampSystem::cmdClampMuxStatistic:
+        protoCmd->m_sOutput = m_ReadMuxStatistic(protoCmd->m_Parsed);
         break;
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
-QString cClampInterface::m_ReadClampChannelCatalog(QString &sInput)
+QString cClampInterface::m_ReadClampChannelCatalog(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
         QString s = "";
@@ -131,45 +208,23 @@ QString cClampInterface::m_ReadClampChannelCatalog(QString &sInput)
 }
 
 
-QString cClampInterface::m_WriteAllClamps(QString &sInput)
+QString cClampInterface::m_WriteAllClamps(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isCommand(0))
     {
-        int n;
-        n = clampHash.count();
-
-        if (n > 0)
-        {
-            bool done;
-            QList<int> keylist;
-
-            keylist = clampHash.keys();
-            done = true;
-
-            for (int i = 0; i < n; i++)
-            {
-                cClamp* pClamp;
-                pClamp = clampHash[keylist.at(i)];
-                done = done && pClamp->exportAdjFlash();
-            }
+        if (isFlashJobPending())
+            return SCPI::scpiAnswer[SCPI::busy];
 
-            if (!done)
-                return SCPI::scpiAnswer[SCPI::errexec];
-        }
-
-        return SCPI::scpiAnswer[SCPI::ack]; // we return ack even in case there is no clamp because nothing went wrong
+        // also without clamps we return a job id, the job simply has nothing to do
+        return QString("%1").arg(m_pMyServer->m_pJobInterface->addJob(new cClampImportJob(this, getSerialList())));
     }
     else
         return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
-QString cClampInterface::m_ImportExportAllClamps(QString &sInput)
+QString cClampInterface::m_ImportExportAllClamps(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
         QString s;
@@ -184,11 +239,8 @@ QString cClampInterface::m_ImportExportAllClamps(QString &sInput)
             keylist = clampHash.keys();
             for (int i = 0; i < n; i++)
             {
-                QString s2;
                 pClamp = clampHash[keylist.at(i)];
-                s2 = pClamp->exportXMLString(-1);
-                s2.replace("\n","");
-                s.append(s2);
+                s.append(pClamp->exportXMLString(-1)); // written in 1 line
             }
         }
 
@@ -196,105 +248,279 @@ QString cClampInterface::m_ImportExportAllClamps(QString &sInput)
     }
     else
     {
-        // here we got 1 to n concenated xml document's that we want distribute to connected clamps.
-        // if we got more than 1 xml document we first check if we have the correct clamps connected
-        // we do this using the serial numbers
-        // if we only have 1 clamp and 1 xml document we accept this document and take the data for
-        // initialzing. so this function can be used by testing field to set up new clamps :-)
-
-        QStringList sl, sl2;
-        QString allXML;
-        QString answer;
-        QString sep = "<!DOCTYPE";
-        int anzXML, anzClamp;
-        bool err;
-
-        allXML = cmd.getParam(); // we fetch all input
-        while (allXML[0] == QChar(' ')) // we remove all leading blanks
-            allXML.remove(0,1);
-
-        sl = allXML.split(sep);
-
-        if (sl.count() > 0)
-            for (int i = 0; i < sl.count(); i++)
-                if (sl.at(i).length() > 0)
-                    sl2.append(sl.at(i));
-
-        anzXML = sl2.count();
-        anzClamp = clampHash.count();
-
-        if ( !((anzXML >0) && (anzClamp > 0)) )
+        QString allXML = cmd.getRawParam().toString(); // we fetch all input
+        return importAllClamps(allXML);
+    }
+}
+
+
+QString cClampInterface::importAllClamps(QString &allXML)
+{
+    QStringList xmlList = splitClampXML(allXML);
+
+    if ( (xmlList.count() == 0) || (clampHash.count() == 0) )
+        return SCPI::scpiAnswer[SCPI::errxml];
+
+    if (isFlashJobPending())
+        return SCPI::scpiAnswer[SCPI::busy];
+
+    // each clamp will be programmed in its own job step
+    return QString("%1").arg(m_pMyServer->m_pJobInterface->addJob(new cClampImportJob(this, xmlList, clampHash.count())));
+}
+
+
+QStringList cClampInterface::splitClampXML(QString &allXML)
+{
+    // here we got 1 to n concenated xml document's that we want distribute to connected clamps.
+    // if we got more than 1 xml document we first check if we have the correct clamps connected
+    // we do this using the serial numbers
+    // if we only have 1 clamp and 1 xml document we accept this document and take the data for
+    // initialzing. so this function can be used by testing field to set up new clamps :-)
+
+    QStringList sl, sl2;
+    QString sep = "<!DOCTYPE";
+
+    while (allXML.startsWith(QChar(' '))) // we remove all leading blanks
+        allXML.remove(0,1);
+
+    sl = allXML.split(sep);
+
+    for (int i = 0; i < sl.count(); i++)
+        if (sl.at(i).length() > 0)
+            sl2.append(sep + sl.at(i));
+
+    return sl2;
+}
+
+
+bool cClampInterface::importClampXML(QString &XML, QString &serial)
+{
+    cClamp tmpClamp;
+
+    serial.clear();
+
+    if (!tmpClamp.importXMLString(XML,true))
+        return false;
+
+    QList<int> keylist;
+    cClamp *pClamp, *pClamp4Use;
+    int anzClamps;
+    int anzSNR;
+
+    anzSNR = 0;
+    keylist = clampHash.keys();
+    anzClamps = keylist.count();
+
+    for (int j = 0; j < anzClamps; j++)
+    {
+        pClamp = clampHash[keylist.at(j)];
+        if (pClamp->getSerial() == tmpClamp.getSerial())
         {
-            err = true;
-            answer = SCPI::scpiAnswer[SCPI::errxml];
+            pClamp4Use = pClamp;
+            anzSNR++;
         }
+    }
 
-        int i;
+    if ( (anzSNR == 1) /*|| ( (anzSNR == 0) && (anzXML == 1) && (anzClamps == 1))*/ )
+    // we have 1 matching serial number
+    {
+        serial = pClamp4Use->getSerial();
+        pClamp4Use->importXMLString(XML,false); // we let the found clamp import its xml data
+        m_pMyServer->m_pSenseInterface->m_ComputeSenseAdjData();
+        // then we let it compute its new adjustment coefficients... we simply call senseinterface's compute
+        // command. we compute a little bit to much but this doesn't matter at all
+        pClamp4Use->startFlashWrite(); // and then we program the clamp, the job writes its pages
+    }
 
-        if (!err)
-            for (i = 0; (i < anzXML) && (anzClamp > 0); i++)
-            {
-                QString XML;
-                cClamp tmpClamp;
-                QDomDocument justqdom( "TheDocument" );
+    return true;
+}
 
-                XML = sep + sl2.at(i);
-                if ( !justqdom.setContent(XML) )
-                {
-                    err = true;
-                    answer = SCPI::scpiAnswer[SCPI::errxml];
-                    break;
-                }
 
-                if (tmpClamp.importXMLDocument(&justqdom,true))
-                {
-                    QList<int> keylist;
-                    cClamp *pClamp, *pClamp4Use;
-                    int anzClamps;
-                    int anzSNR;
-
-                    anzSNR = 0;
-                    keylist = clampHash.keys();
-                    anzClamps = keylist.count();
-
-                    for (int j = 0; j < anzClamps; j++)
-                    {
-                        pClamp = clampHash[keylist.at(j)];
-                        if (pClamp->getSerial() == tmpClamp.getSerial())
-                        {
-                            pClamp4Use = pClamp;
-                            anzSNR++;
-                        }
-                    }
+cClamp *cClampInterface::getClamp(QString serial)
+{
+    QList<cClamp*> clampList = clampHash.values();
 
-                    if ( (anzSNR == 1) /*|| ( (anzSNR == 0) && (anzXML == 1) && (anzClamps == 1))*/ )
-                    // we have 1 matching serial number
-                    {
-                        anzClamp--;
-                        pClamp4Use->importXMLDocument(&justqdom,false); // we let the found clamp import its xml data
-                        m_pMyServer->m_pSenseInterface->m_ComputeSenseAdjData();
-                        // then we let it compute its new adjustment coefficients... we simply call senseinterface's compute
-                        // command. we compute a little bit to much but this doesn't matter at all
-                        if (!pClamp4Use->exportAdjFlash()) // and then we program the clamp
-                        {
-                            err = true;
-                            answer = SCPI::scpiAnswer[SCPI::errexec];
-                            break;
-                        }
-                    }
-                }
-                else
-                {
-                    err = true;
-                    answer = SCPI::scpiAnswer[SCPI::errxml];
-                    break;
-                }
+    for (int i = 0; i < clampList.count(); i++)
+        if (clampList.at(i)->getSerial() == serial)
+            return clampList.at(i);
 
+    return 0;
+}
+
+
+QStringList cClampInterface::getSerialList()
+{
+    QStringList serialList;
+    QList<cClamp*> clampList = clampHash.values();
+
+    for (int i = 0; i < clampList.count(); i++)
+        serialList.append(clampList.at(i)->getSerial());
+
+    return serialList;
+}
+
+
+void cClampInterface::addFlashJob()
+{
+    m_nFlashJobs++;
+}
+
+
+void cClampInterface::removeFlashJob()
+{
+    m_nFlashJobs--;
+}
+
+
+bool cClampInterface::isFlashJobPending()
+{
+    return (m_nFlashJobs > 0);
+}
+
+
+cClampImportJob::cClampImportJob(cClampInterface *clampInterface, QStringList xmlList, int anzClamp)
+    :m_pClampInterface(clampInterface), m_XMLList(xmlList), m_nClampsLeft(anzClamp), m_bImported(false), m_nPagesDone(0), m_nPagesWritten(0)
+{
+    m_pClampInterface->addFlashJob();
+}
+
+
+cClampImportJob::cClampImportJob(cClampInterface *clampInterface, QStringList serialList)
+    :m_pClampInterface(clampInterface), m_nClampsLeft(0), m_bImported(false), m_SerialList(serialList), m_nPagesDone(0), m_nPagesWritten(0)
+{
+    m_pClampInterface->addFlashJob();
+}
+
+
+cClampImportJob::~cClampImportJob()
+{
+    m_pClampInterface->removeFlashJob();
+}
+
+
+bool cClampImportJob::step()
+{
+    if (!m_bImported)
+    {
+        // importing is fast, so we do all documents at once and know how many pages we have to write
+        m_bImported = true;
+        for (int i = 0; (i < m_XMLList.count()) && (m_nClampsLeft > 0); i++)
+        {
+            QString serial;
+            QString XML = m_XMLList.at(i);
+
+            if (!m_pClampInterface->importClampXML(XML, serial))
+            {
+                m_bFailed = true;
+                return false;
+            }
+
+            if (!serial.isEmpty())
+            {
+                m_nClampsLeft--;
+                m_SerialList.append(serial);
+            }
+        }
+
+        for (int i = 0; i < m_SerialList.count(); i++)
+        {
+            cClamp* clamp = m_pClampInterface->getClamp(m_SerialList.at(i));
+            if (clamp == 0)
+            {
+                m_bFailed = true; // the clamp was removed before we started
+                return false;
             }
 
-        if (!err)
-            answer = SCPI::scpiAnswer[SCPI::ack];
+            if (m_XMLList.isEmpty())
+                clamp->startFlashWrite(); // without import we write the clamp's actual data
+            m_nTotal += clamp->getFlashWritePages();
+        }
+
+        return !m_SerialList.isEmpty();
+    }
+
+    cClamp* clamp = m_pClampInterface->getClamp(m_SerialList.first());
+    if ( (clamp == 0) || !clamp->writeFlashPages(Job::FlashPagesPerStep) )
+    {
+        m_bFailed = true; // write error or the clamp was removed meanwhile
+        return false;
+    }
+
+    m_nProgress = m_nPagesDone + clamp->getFlashWritePos();
+    if (clamp->isFlashWriteDone())
+    {
+        m_nPagesDone += clamp->getFlashWritePages();
+        m_nPagesWritten += clamp->getPagesWritten();
+        m_SerialList.removeFirst();
+    }
+
+    return !m_SerialList.isEmpty();
+}
 
+
+QString cClampImportJob::getResult()
+{
+    return QString("%1").arg(m_nPagesWritten);
+}
+
+
+QString cClampInterface::m_XMLUploadBegin(cProtonetCommand *protoCmd)
+{
+    if (protoCmd->m_Parsed.isCommand(0))
+    {
+        if (!m_XMLUpload.begin(protoCmd))
+            return SCPI::scpiAnswer[SCPI::busy]; // another client is uploading
+        return SCPI::scpiAnswer[SCPI::ack];
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cClampInterface::m_XMLUploadAppend(cProtonetCommand *protoCmd)
+{
+    const cParsedCommand& cmd = protoCmd->m_Parsed;
+
+    if (!cmd.isQuery() && (cmd.getParamCount() > 0))
+    {
+        if (m_XMLUpload.isBusy(protoCmd))
+            return SCPI::scpiAnswer[SCPI::busy];
+
+        // the chunk is taken as sent, xml data contains ; and blanks itself
+        if (m_XMLUpload.append(protoCmd, cmd.getRawParam()))
+            return SCPI::scpiAnswer[SCPI::ack];
+        else
+            return SCPI::scpiAnswer[SCPI::errexec];
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cClampInterface::m_XMLUploadCommit(cProtonetCommand *protoCmd)
+{
+    if (protoCmd->m_Parsed.isCommand(0))
+    {
+        if (m_XMLUpload.isBusy(protoCmd))
+            return SCPI::scpiAnswer[SCPI::busy];
+        if (!m_XMLUpload.isActive(protoCmd))
+            return SCPI::scpiAnswer[SCPI::errexec];
+        if (isFlashJobPending())
+            return SCPI::scpiAnswer[SCPI::busy]; // the upload stays, it can be committed again later
+
+        QString answer = importAllClamps(m_XMLUpload.data());
+        m_XMLUpload.clear();
         return answer;
     }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cClampInterface::m_ReadMuxStatistic(const cParsedCommand &cmd)
+{
+    if (cmd.isQuery())
+        return QString("%1;%2").arg(m_pClampMux->getSwitchCount()).arg(m_pClampMux->getSkipCount());
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
 }
@@ -3,8 +3,12 @@
 
 #include <QHash>
 #include <QStringList>
+#include <QThread>
+#include <QElapsedTimer>
 
 #include "scpiconnection.h"
+#include "uploadbuffer.h"
+#include "job.h"
 
 
 // here we hold the clamps that are hotplugged to the system
@@ -12,6 +16,9 @@
 class cMT310S2dServer;
 class cATMEL;
 class cClamp;
+class cClampReader;
+class cClampMux;
+class cParsedCommand;
 
 
 namespace ClampSystem
@@ -21,23 +28,43 @@ enum ClampCommands
 {
     cmdClampChannelCat,
     cmdClampWrite,
-    cmdClampImportExport
+    cmdClampImportExport,
+    cmdClampXMLBegin,
+    cmdClampXMLAppend,
+    cmdClampXMLCommit,
+    cmdClampMuxStatistic
 };
 }
 
 class cClampInterface: public cSCPIConnection
 {
+    Q_OBJECT
 
 public:
     cClampInterface(cMT310S2dServer *server, cATMEL* controler);
+    virtual ~cClampInterface();
     virtual void initSCPIConnection(QString leadingNodes);
     void actualizeClampStatus();
     void addChannel(QString channel);
     void removeChannel(QString channel);
+    bool importClampXML(QString& XML, QString& serial); // 1 document, serial is set if we found the clamp for it, its flash write is started then
+    cClamp* getClamp(QString serial); // 0 if no such clamp is connected
+    QStringList getSerialList(); // of all connected clamps
+    void addFlashJob(); // a job writing clamp flash was queued
+    void removeFlashJob(); // and it is gone
+    bool isFlashJobPending(); // all clamps share the mux, so direct access to any clamp flash gets busy then
+    cClampMux* getClampMux();
+
+signals:
+    void readClamp(int ctrlChannel, QString channelName, quint32 seq); // to our clamp reader
+    void clampsChanged(); // a clamp was built or removed together with its scpi commands
 
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
+private slots:
+    void clampRead(int ctrlChannel, QByteArray image, quint16 chksum, bool fromFlash, quint32 seq, qint64 ms);
+
 private:
     cMT310S2dServer *m_pMyServer;
     cATMEL *m_pControler;
@@ -46,10 +73,45 @@ private:
     quint16 m_nClampStatus;
     QHash<int, cClamp*> clampHash;
 
-    QString m_ReadClampChannelCatalog(QString& sInput);
-    QString m_WriteAllClamps(QString& sInput);
-    QString m_ImportExportAllClamps(QString& sInput);
+    cClampMux* m_pClampMux; // all clamp flash access goes through here
+    QThread m_ReaderThread; // clamp images are read here, clamps are built in the main thread
+    cClampReader* m_pClampReader;
+    QHash<int, quint32> m_ReadSeqHash; // increases with each plug event, so we can drop outdated images
+    QHash<int, QElapsedTimer> m_PlugTimerHash; // plug to ready latency
+    int m_nFlashJobs;
+
+    QString m_ReadClampChannelCatalog(const cParsedCommand& cmd);
+    QString m_WriteAllClamps(const cParsedCommand& cmd);
+    QString m_ImportExportAllClamps(const cParsedCommand& cmd);
+    QString m_XMLUploadBegin(cProtonetCommand* protoCmd);
+    QString m_XMLUploadAppend(cProtonetCommand* protoCmd);
+    QString m_XMLUploadCommit(cProtonetCommand* protoCmd);
+    QString m_ReadMuxStatistic(const cParsedCommand& cmd);
+
+    cUploadBuffer m_XMLUpload; // chunked SYSTEM:ADJUSTMENT:CLAMP:XML
+    QString importAllClamps(QString& allXML); // starts a job and returns its id
+    QStringList splitClampXML(QString& allXML);
+
+};
+
 
+class cClampImportJob: public cJob // distributes xml documents to the connected clamps, then writes their flash some pages per step
+{
+public:
+    cClampImportJob(cClampInterface* clampInterface, QStringList xmlList, int anzClamp);
+    cClampImportJob(cClampInterface* clampInterface, QStringList serialList); // no import, only writes the flash of these clamps
+    virtual ~cClampImportJob();
+    virtual bool step();
+    virtual QString getResult(); // pages actually written over all clamps
+
+private:
+    cClampInterface* m_pClampInterface;
+    QStringList m_XMLList;
+    int m_nClampsLeft;
+    bool m_bImported;
+    QStringList m_SerialList; // clamps whose flash is still to write, we look them up each step because they might be removed
+    quint32 m_nPagesDone; // pages of clamps written completely
+    quint32 m_nPagesWritten; // of these the pages that differed
 };
 
 #endif // CLAMPINTERFACE
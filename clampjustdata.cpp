@@ -3,6 +3,27 @@
 #include "clampjustdata.h"
 #include "justdata.h"
 
+static QVector<double> addPolynom(const QVector<double>& p1, const QVector<double>& p2)
+{
+    QVector<double> p(qMax(p1.count(), p2.count()), 0.0);
+    for (int i = 0; i < p1.count(); i++)
+        p[i] += p1.at(i);
+    for (int i = 0; i < p2.count(); i++)
+        p[i] += p2.at(i);
+    return p;
+}
+
+
+static QVector<double> mulPolynom(const QVector<double>& p1, const QVector<double>& p2)
+{
+    QVector<double> p(p1.count() + p2.count() - 1, 0.0);
+    for (int i = 0; i < p1.count(); i++)
+        for (int j = 0; j < p2.count(); j++)
+            p[i+j] += p1.at(i) * p2.at(j);
+    return p;
+}
+
+
 cClampJustData::cClampJustData(cSCPI *scpiinterface, cSenseRange *cascadedRange)
     :cMT310S2JustData(scpiinterface), m_pFirstStageRange(cascadedRange)
 {   
@@ -45,3 +66,19 @@ double cClampJustData::getJustOffsetCorrection(double par)
 }
 
 
+QVector<double> cClampJustData::getGainCoefficients()
+{
+    return mulPolynom(m_pGainCorrection->getCoefficients(), m_pFirstStageRange->getJustData()->getGainCoefficients());
+}
+
+
+QVector<double> cClampJustData::getPhaseCoefficients()
+{
+    return addPolynom(m_pPhaseCorrection->getCoefficients(), m_pFirstStageRange->getJustData()->getPhaseCoefficients());
+}
+
+
+QVector<double> cClampJustData::getOffsetCoefficients()
+{
+    return addPolynom(m_pOffsetCorrection->getCoefficients(), m_pFirstStageRange->getJustData()->getOffsetCoefficients());
+}
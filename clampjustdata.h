@@ -20,6 +20,10 @@ class cClampJustData: public cMT310S2JustData
 public:
     cClampJustData(cSCPI* scpiinterface, cSenseRange* cascadedRange);
 
+    virtual QVector<double> getGainCoefficients(); // product of both stages' polynoms
+    virtual QVector<double> getPhaseCoefficients(); // sum of both stages' polynoms
+    virtual QVector<double> getOffsetCoefficients(); // same
+
 protected:
     virtual double getGainCorrection(double par);
     virtual double getJustGainCorrection(double par);
@@ -0,0 +1,49 @@
+#include "i2cutils.h"
+
+#include "clampmux.h"
+
+
+cClampMux::cClampMux(QString devnode, quint8 muxadr)
+    :m_sDeviceNode(devnode), m_nMuxAdr(muxadr), m_nSelected(-1), m_nSwitchCount(0), m_nSkipCount(0)
+{
+}
+
+
+QMutex* cClampMux::getLock()
+{
+    return &m_Lock;
+}
+
+
+void cClampMux::select(quint8 ctrlChannel)
+{
+    if (m_nSelected == ctrlChannel)
+    {
+        m_nSkipCount++;
+        return;
+    }
+
+    uchar outpBuf[1]; // 1 adr byte, 1 byte data = mux code
+    outpBuf[0] = (ctrlChannel - 4) | 8; // .... hardware ????
+
+    struct i2c_msg Msgs = {addr: m_nMuxAdr, flags: 0, len: 1, buf:  outpBuf }; // 1 message
+    struct i2c_rdwr_ioctl_data MuxData = { msgs: &(Msgs), nmsgs: 1 };
+
+    m_nSwitchCount++;
+    if (I2CTransfer(m_sDeviceNode, m_nMuxAdr, 0, &MuxData))
+        m_nSelected = -1; // error, so we write it again next time
+    else
+        m_nSelected = ctrlChannel;
+}
+
+
+quint32 cClampMux::getSwitchCount()
+{
+    return m_nSwitchCount;
+}
+
+
+quint32 cClampMux::getSkipCount()
+{
+    return m_nSkipCount;
+}
@@ -0,0 +1,29 @@
+#ifndef CLAMPMUX_H
+#define CLAMPMUX_H
+
+#include <QString>
+#include <QMutex>
+
+// the clamps' flash memories share 1 address behind the flash mux. we remember the mux
+// selection so we only write it if it changes. mux selection and the following flash
+// access must not be interleaved by another thread, so the whole sequence holds our lock
+
+class cClampMux
+{
+public:
+    cClampMux(QString devnode, quint8 muxadr);
+    QMutex* getLock(); // hold it while selecting and accessing the flash
+    void select(quint8 ctrlChannel); // only with lock held
+    quint32 getSwitchCount(); // mux writes
+    quint32 getSkipCount(); // mux writes we could spare
+
+private:
+    QMutex m_Lock;
+    QString m_sDeviceNode;
+    quint8 m_nMuxAdr;
+    int m_nSelected; // ctrl channel selected, -1 if unknown
+    quint32 m_nSwitchCount;
+    quint32 m_nSkipCount;
+};
+
+#endif // CLAMPMUX_H
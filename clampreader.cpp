@@ -0,0 +1,76 @@
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <syslog.h>
+
+#include "mt310s2dglobal.h"
+#include "adjustment.h"
+#include "clamp.h"
+#include "clampmux.h"
+#include "clampreader.h"
+
+
+cClampReader::cClampReader(QString devnode, quint8 dlevel, quint8 i2cadr, cClampMux *mux)
+    :cAdjFlash(devnode, dlevel, i2cadr), m_pClampMux(mux), m_nCtrlChannel(0)
+{
+}
+
+
+quint8 cClampReader::getAdjustmentStatus()
+{
+    return Adjustment::notAdjusted; // we only read images, the clamp knows its status
+}
+
+
+void cClampReader::readClamp(int ctrlChannel, QString channelName, quint32 seq)
+{
+    QElapsedTimer timer;
+    QByteArray image;
+
+    timer.start();
+    m_nCtrlChannel = ctrlChannel;
+    m_sChannelName = channelName;
+    m_sSerial.clear();
+
+    {
+        QMutexLocker locker(m_pClampMux->getLock());
+
+        setI2CMux();
+        // the header tells us the clamp's type and serial, we only read the whole image if we know the type
+        if (readFlashHeader(image, clamp::HeaderLength) && (image.size() > 6))
+        {
+            quint8 type = (quint8) image.at(6);
+            m_sSerial = cClamp::readSerial(image);
+            if ( (type == undefined) || (type >= anzCL) || !readFlashImage(image) )
+                image.clear();
+        }
+        else
+            image.clear();
+    }
+
+    if DEBUG2 syslog(LOG_INFO,"clamp on %s read in %lld ms\n", channelName.toLatin1().data(), timer.elapsed());
+    // chksum verified if image isn't empty, our shadow is only set if the image came from flash
+    emit clampRead(ctrlChannel, image, m_nChecksum, !m_ShadowImage.isEmpty(), seq, timer.elapsed());
+}
+
+
+void cClampReader::exportAdjData(QDataStream&)
+{
+}
+
+
+bool cClampReader::importAdjData(QDataStream&)
+{
+    return false;
+}
+
+
+void cClampReader::setI2CMux()
+{
+    m_pClampMux->select(m_nCtrlChannel);
+}
+
+
+QString cClampReader::getCacheKey()
+{
+    return cClamp::cacheKey(m_sSerial); // the same as the clamp's, so we share the cache
+}
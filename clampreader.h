@@ -0,0 +1,43 @@
+#ifndef CLAMPREADER_H
+#define CLAMPREADER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+#include "adjflash.h"
+
+class cClampMux;
+
+// reads the eeprom image of a hotplugged clamp. the reader lives in its own thread,
+// so the server keeps on answering while mux and flash are accessed. the clamp interface
+// gets the image by signal and builds the clamp in the main thread all at once
+
+class cClampReader: public QObject, public cAdjFlash
+{
+    Q_OBJECT
+
+public:
+    cClampReader(QString devnode, quint8 dlevel, quint8 i2cadr, cClampMux* mux);
+    virtual quint8 getAdjustmentStatus();
+
+public slots:
+    void readClamp(int ctrlChannel, QString channelName, quint32 seq);
+
+signals:
+    void clampRead(int ctrlChannel, QByteArray image, quint16 chksum, bool fromFlash, quint32 seq, qint64 ms); // empty image if no known clamp, fromFlash false if cached
+
+protected:
+    virtual void exportAdjData(QDataStream&);
+    virtual bool importAdjData(QDataStream&);
+    virtual void setI2CMux();
+    virtual QString getCacheKey();
+
+private:
+    cClampMux* m_pClampMux; // shared with the clamps
+    quint8 m_nCtrlChannel; // the clamp we are just reading
+    QString m_sChannelName;
+    QString m_sSerial; // of the clamp we are just reading, from its flash header
+};
+
+#endif // CLAMPREADER_H
@@ -34,15 +34,19 @@ void cFPZChannel::initSCPIConnection(QString leadingNodes)
         leadingNodes += ":";
 
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"ALIAS", SCPI::isQuery, m_pSCPIInterface, FPZChannel::cmdAlias);
+    delegate->setStaticReply(m_sAlias);
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"TYPE", SCPI::isQuery, m_pSCPIInterface, FPZChannel::cmdType);
+    delegate->setStaticReply(QString("%1").arg(m_nType));
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"DSPSERVER", SCPI::isQuery, m_pSCPIInterface, FPZChannel::cmdDspServer);
+    delegate->setStaticReply(QString("%1").arg(m_nDspServer));
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"DSPCHANNEL", SCPI::isQuery, m_pSCPIInterface, FPZChannel::cmdDspChannel);
+    delegate->setStaticReply(QString("%1").arg(m_nDspChannel));
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"STATUS", SCPI::isQuery, m_pSCPIInterface, FPZChannel::cmdStatus);
@@ -91,7 +95,7 @@ void cFPZChannel::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
@@ -28,6 +28,7 @@ void cFPZInChannel::initSCPIConnection(QString leadingNodes)
         leadingNodes += ":";
 
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"ALIAS", SCPI::isQuery, m_pSCPIInterface, FPZINChannel::cmdAlias);
+    delegate->setStaticReply(m_sAlias);
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"STATUS", SCPI::isQuery, m_pSCPIInterface, FPZINChannel::cmdStatus);
@@ -49,7 +50,7 @@ void cFPZInChannel::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
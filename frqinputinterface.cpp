@@ -11,6 +11,13 @@
 #include "protonetcommand.h"
 
 
+static const cSCPIDelegateDescriptor FRQInputCommands[] =
+{
+    { "FRQINPUT",         "VERSION", SCPI::isQuery, FRQInputSystem::cmdVersion },
+    { "FRQINPUT:CHANNEL", "CATALOG", SCPI::isQuery, FRQInputSystem::cmdChannelCat },
+};
+
+
 cFRQInputInterface::cFRQInputInterface(cMT310S2dServer *server)
     :m_pMyServer(server)
 {
@@ -47,22 +54,15 @@ cFRQInputInterface::~cFRQInputInterface()
 
 void cFRQInputInterface::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1FRQINPUT").arg(leadingNodes),"VERSION",SCPI::isQuery, m_pSCPIInterface, FRQInputSystem::cmdVersion);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1FRQINPUT:CHANNEL").arg(leadingNodes),"CATALOG", SCPI::isQuery, m_pSCPIInterface, FRQInputSystem::cmdChannelCat);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, FRQInputCommands);
+    findDelegate(FRQInputSystem::cmdVersion)->setStaticReply(m_sVersion);
 
     for (int i = 0; i < m_ChannelList.count(); i++)
     {
         connect(m_ChannelList.at(i), SIGNAL(notifier(cNotificationString*)), this, SIGNAL(notifier(cNotificationString*)));
-        connect(m_ChannelList.at(i), SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
         m_ChannelList.at(i)->initSCPIConnection(QString("%1FRQINPUT").arg(leadingNodes));
     }
 }
@@ -103,7 +103,7 @@ void cFRQInputInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
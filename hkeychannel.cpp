@@ -28,6 +28,7 @@ void cHKeyChannel::initSCPIConnection(QString leadingNodes)
         leadingNodes += ":";
 
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"ALIAS", SCPI::isQuery, m_pSCPIInterface, HKEYChannel::cmdAlias);
+    delegate->setStaticReply(m_sAlias);
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"STATUS", SCPI::isQuery, m_pSCPIInterface, HKEYChannel::cmdStatus);
@@ -49,7 +50,7 @@ void cHKeyChannel::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
@@ -11,6 +11,13 @@
 #include "protonetcommand.h"
 
 
+static const cSCPIDelegateDescriptor HKeyCommands[] =
+{
+    { "HKEY",         "VERSION", SCPI::isQuery, HKeySystem::cmdVersion },
+    { "HKEY:CHANNEL", "CATALOG", SCPI::isQuery, HKeySystem::cmdChannelCat },
+};
+
+
 cHKeyInterface::cHKeyInterface(cMT310S2dServer *server)
     :m_pMyServer(server)
 {
@@ -41,22 +48,15 @@ cHKeyInterface::~cHKeyInterface()
 
 void cHKeyInterface::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1HKEY").arg(leadingNodes),"VERSION",SCPI::isQuery, m_pSCPIInterface, HKeySystem::cmdVersion);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1HKEY:CHANNEL").arg(leadingNodes),"CATALOG", SCPI::isQuery, m_pSCPIInterface, HKeySystem::cmdChannelCat);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, HKeyCommands);
+    findDelegate(HKeySystem::cmdVersion)->setStaticReply(m_sVersion);
 
     for (int i = 0; i < m_ChannelList.count(); i++)
     {
         connect(m_ChannelList.at(i), SIGNAL(notifier(cNotificationString*)), this, SIGNAL(notifier(cNotificationString*)));
-        connect(m_ChannelList.at(i), SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
         m_ChannelList.at(i)->initSCPIConnection(QString("%1HKEY").arg(leadingNodes));
     }
 }
@@ -97,7 +97,7 @@ void cHKeyInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
@@ -0,0 +1,121 @@
+#include "job.h"
+#include "adjflash.h"
+
+extern cATMEL* pAtmel;
+
+
+cJob::cJob()
+    :m_bFailed(false), m_nProgress(0), m_nTotal(0)
+{
+}
+
+
+bool cJob::hasFailed()
+{
+    return m_bFailed;
+}
+
+
+quint32 cJob::getProgress()
+{
+    return m_nProgress;
+}
+
+
+quint32 cJob::getTotal()
+{
+    return m_nTotal;
+}
+
+
+QString cJob::getResult()
+{
+    return QString();
+}
+
+
+int cAtmelLoadJob::m_nPending = 0;
+
+
+cAtmelLoadJob::cAtmelLoadJob(bl_cmdcode blwriteCmd, QString filename)
+    :m_blwriteCmd(blwriteCmd), m_sFilename(filename)
+{
+    m_nPending++;
+}
+
+
+cAtmelLoadJob::~cAtmelLoadJob()
+{
+    m_nPending--;
+}
+
+
+bool cAtmelLoadJob::isPending()
+{
+    return (m_nPending > 0);
+}
+
+
+bool cAtmelLoadJob::step()
+{
+    if (m_nProgress == 0)
+    {
+        // first we read the hexfile and fetch the bootloader info
+        if ( !m_IntelHexData.ReadHexFile(m_sFilename) || (pAtmel->startLoadMemory(m_blwriteCmd, m_IntelHexData, m_LoadState) != cmddone) )
+        {
+            m_bFailed = true;
+            return false;
+        }
+    }
+    else
+    {
+        if (pAtmel->loadMemoryBlock(m_IntelHexData, m_LoadState) != cmddone)
+        {
+            m_bFailed = true;
+            return false;
+        }
+    }
+
+    m_nProgress++;
+    return (m_LoadState.MemByteArray.count() > 0); // more blocks to write
+}
+
+
+cAdjFlashWriteJob::cAdjFlashWriteJob(cAdjFlash *adjFlash)
+    :m_pAdjFlash(adjFlash), m_bStarted(false)
+{
+    m_pAdjFlash->addFlashJob(); // until we are done nobody else accesses this flash
+}
+
+
+cAdjFlashWriteJob::~cAdjFlashWriteJob()
+{
+    m_pAdjFlash->removeFlashJob();
+}
+
+
+bool cAdjFlashWriteJob::step()
+{
+    if (!m_bStarted)
+    {
+        m_pAdjFlash->startFlashWrite();
+        m_nTotal = m_pAdjFlash->getFlashWritePages(); // progress is counted in pages
+        m_bStarted = true;
+        return true;
+    }
+
+    if (!m_pAdjFlash->writeFlashPages(Job::FlashPagesPerStep))
+    {
+        m_bFailed = true;
+        return false;
+    }
+
+    m_nProgress = m_pAdjFlash->getFlashWritePos();
+    return !m_pAdjFlash->isFlashWriteDone();
+}
+
+
+QString cAdjFlashWriteJob::getResult()
+{
+    return QString("%1").arg(m_pAdjFlash->getPagesWritten());
+}
@@ -0,0 +1,79 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include <QString>
+#include <QStringList>
+#include <intelhexfileio.h>
+
+#include "atmel.h"
+
+// long running operations are done as jobs. the job interface calls step() once per
+// event loop cycle, so the server keeps on answering commands while a job is running
+
+namespace Job
+{
+enum States
+{
+    queued,
+    running,
+    finished,
+    failed
+};
+
+const QString sStates[4] = {"queued", "running", "finished", "failed"};
+
+const int FlashPagesPerStep = 4; // adjustment flash pages written per step, a page write takes about 5ms
+}
+
+class cAdjFlash;
+
+class cJob
+{
+public:
+    cJob();
+    virtual ~cJob(){}
+    virtual bool step() = 0; // does the next part of the work, false if nothing is left to do
+    bool hasFailed();
+    quint32 getProgress(); // work done, in units of the job
+    quint32 getTotal(); // work to do in the same units, 0 if not known
+    virtual QString getResult(); // job specific, appended to the job state if not empty
+
+protected:
+    bool m_bFailed;
+    quint32 m_nProgress;
+    quint32 m_nTotal;
+};
+
+
+class cAtmelLoadJob: public cJob // programs atmel's flash or eeprom block by block
+{
+public:
+    cAtmelLoadJob(bl_cmdcode blwriteCmd, QString filename);
+    virtual ~cAtmelLoadJob();
+    virtual bool step();
+    static bool isPending(); // a load job is queued or running, the controler must not be started then
+
+private:
+    static int m_nPending;
+
+    bl_cmdcode m_blwriteCmd;
+    QString m_sFilename;
+    cIntelHexFileIO m_IntelHexData;
+    blLoadState m_LoadState;
+};
+
+
+class cAdjFlashWriteJob: public cJob // builds the image first, then writes some pages per step
+{
+public:
+    cAdjFlashWriteJob(cAdjFlash* adjFlash); // for flash owners living as long as the server, clamps have cClampImportJob
+    virtual ~cAdjFlashWriteJob();
+    virtual bool step();
+    virtual QString getResult(); // pages actually written, unchanged pages are skipped
+
+private:
+    cAdjFlash* m_pAdjFlash;
+    bool m_bStarted;
+};
+
+#endif // JOB_H
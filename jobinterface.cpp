@@ -0,0 +1,139 @@
+#include <QTimer>
+#include <scpi.h>
+
+#include "mt310s2d.h"
+#include "job.h"
+#include "jobinterface.h"
+#include "protonetcommand.h"
+#include "parsedcommand.h"
+
+
+cJobInterface::cJobInterface(cMT310S2dServer *server)
+    :m_pMyServer(server)
+{
+    m_pSCPIInterface = m_pMyServer->getSCPIInterface();
+    m_nNextJobId = 1;
+    notifierJobStatus = "0;finished;0;0"; // nothing has been done yet
+}
+
+
+cJobInterface::~cJobInterface()
+{
+    for (int i = 0; i < m_JobList.count(); i++)
+        delete m_JobList.at(i);
+}
+
+
+void cJobInterface::initSCPIConnection(QString leadingNodes)
+{
+    cSCPIDelegate* delegate;
+
+    if (leadingNodes != "")
+        leadingNodes += ":";
+
+    delegate = new cSCPIDelegate(QString("%1SYSTEM:JOB").arg(leadingNodes),"STATUS", SCPI::isQuery, m_pSCPIInterface, JobSystem::cmdStatus);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    delegate = new cSCPIDelegate(QString("%1SYSTEM:JOB").arg(leadingNodes),"STATE", SCPI::CmdwP, m_pSCPIInterface, JobSystem::cmdState);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+}
+
+
+quint32 cJobInterface::addJob(cJob *job)
+{
+    quint32 id = m_nNextJobId++;
+
+    m_JobList.append(job);
+    m_JobIdList.append(id);
+    setJobState(id, job, Job::queued);
+
+    if (m_JobList.count() == 1) // no job was running, so we start
+        QTimer::singleShot(0, this, SLOT(runJobStep()));
+
+    return id;
+}
+
+
+void cJobInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
+{
+    switch (cmdCode)
+    {
+    case JobSystem::cmdStatus:
+        protoCmd->m_sOutput = m_ReadJobStatus(protoCmd->m_Parsed);
+        break;
+    case JobSystem::cmdState:
+        protoCmd->m_sOutput = m_ReadJobState(protoCmd->m_Parsed);
+        break;
+    }
+
+    if (protoCmd->m_bwithOutput)
+        protoCmd->sendAnswer();
+}
+
+
+void cJobInterface::runJobStep()
+{
+    if (m_JobList.isEmpty())
+        return;
+
+    cJob* job = m_JobList.first();
+    quint32 id = m_JobIdList.first();
+
+    if (job->step())
+    {
+        setJobState(id, job, Job::running);
+    }
+    else
+    {
+        setJobState(id, job, job->hasFailed() ? Job::failed : Job::finished);
+        delete m_JobList.takeFirst();
+        m_JobIdList.removeFirst();
+
+        m_FinishedIdList.append(id);
+        if (m_FinishedIdList.count() > JobSystem::MaxJobHistory)
+            m_JobStateHash.remove(m_FinishedIdList.takeFirst());
+    }
+
+    if (!m_JobList.isEmpty()) // the event loop runs between 2 steps
+        QTimer::singleShot(0, this, SLOT(runJobStep()));
+}
+
+
+QString cJobInterface::m_ReadJobStatus(const cParsedCommand &cmd)
+{
+    if (cmd.isQuery())
+    {
+        emit notifier(&notifierJobStatus);
+        return notifierJobStatus.getString();
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cJobInterface::m_ReadJobState(const cParsedCommand &cmd)
+{
+    if (cmd.isQuery(1))
+    {
+        bool ok;
+        quint32 id = cmd.getParam(0).toULong(&ok);
+        if (ok && m_JobStateHash.contains(id))
+            return m_JobStateHash[id];
+        else
+            return SCPI::scpiAnswer[SCPI::errval];
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+void cJobInterface::setJobState(quint32 id, cJob *job, int state)
+{
+    QString s = QString("%1;%2;%3").arg(Job::sStates[state]).arg(job->getProgress()).arg(job->getTotal());
+    QString result = job->getResult();
+    if ( (state == Job::finished) && !result.isEmpty() )
+        s += QString(";%1").arg(result);
+    m_JobStateHash[id] = s;
+    notifierJobStatus = QString("%1;%2").arg(id).arg(s);
+}
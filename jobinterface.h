@@ -0,0 +1,59 @@
+#ifndef JOBINTERFACE_H
+#define JOBINTERFACE_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+
+#include "scpiconnection.h"
+#include "notificationstring.h"
+
+namespace JobSystem
+{
+
+enum Commands
+{
+    cmdStatus,
+    cmdState
+};
+
+const int MaxJobHistory = 32; // that many finished jobs can still be queried
+}
+
+class cMT310S2dServer;
+class cJob;
+class cParsedCommand;
+
+
+class cJobInterface: public cSCPIConnection
+{
+    Q_OBJECT
+
+public:
+    cJobInterface(cMT310S2dServer* server);
+    virtual ~cJobInterface();
+    virtual void initSCPIConnection(QString leadingNodes);
+    quint32 addJob(cJob* job); // we take ownership of the job and return its id
+
+protected slots:
+    virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
+
+private slots:
+    void runJobStep();
+
+private:
+    cMT310S2dServer* m_pMyServer;
+    QList<cJob*> m_JobList; // the first job is the running one
+    QList<quint32> m_JobIdList;
+    QList<quint32> m_FinishedIdList;
+    QHash<quint32, QString> m_JobStateHash; // id -> state;progress;total[;result]
+    quint32 m_nNextJobId;
+
+    QString m_ReadJobStatus(const cParsedCommand& cmd);
+    QString m_ReadJobState(const cParsedCommand& cmd);
+
+    cNotificationString notifierJobStatus; // id;state;progress;total of the job that changed last
+    void setJobState(quint32 id, cJob* job, int state);
+};
+
+#endif // JOBINTERFACE_H
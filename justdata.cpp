@@ -1,4 +1,5 @@
 #include <QDataStream>
+#include <QList>
 #include <QString>
 #include <math.h>
 #include <scpi.h>
@@ -8,7 +9,6 @@
 #include "protonetcommand.h"
 #include "atmel.h"
 #include "scpiconnection.h"
-#include "scpidelegate.h"
 #include "justdata.h"
 #include "justnode.h"
 
@@ -16,7 +16,7 @@
 extern cATMEL* pAtmel;
 
 cJustData::cJustData(cSCPI* scpiinterface, int order, double init)
-    : m_nOrder(order)
+    : m_nStatus(0), m_nOrder(order), m_nTableResolution(0), m_fTableArgMax(0.0), m_fTableStep(0.0)
 {
     m_pSCPIInterface = scpiinterface;
     m_pCoefficient = new double[order+1];  
@@ -32,42 +32,9 @@ cJustData::~cJustData()
 }
 
 
-void cJustData::initSCPIConnection(QString leadingNodes)
+void cJustData::initSCPIConnection(QString)
 {
-    cSCPIDelegate* delegate;
-
-    delegate = new cSCPIDelegate(QString("%1").arg(leadingNodes), "STATUS", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustStatus);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-
-    if (leadingNodes != "")
-        leadingNodes += ":";
-
-    delegate = new cSCPIDelegate(QString("%1COEFFICIENT").arg(leadingNodes), "0", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustCoefficient0);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1COEFFICIENT").arg(leadingNodes), "1", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustCoefficient1);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1COEFFICIENT").arg(leadingNodes), "2", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustCoefficient2);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1COEFFICIENT").arg(leadingNodes), "3", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustCoefficient3);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1NODE").arg(leadingNodes), "0", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustNode0);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1NODE").arg(leadingNodes), "1", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustNode1);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1NODE").arg(leadingNodes), "2", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustNode2);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1NODE").arg(leadingNodes), "3", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, JustNode3);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-
+    // our commands are routed by the sense interface
 }
 
 
@@ -102,10 +69,22 @@ void cJustData::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     case JustNode3:
         protoCmd->m_sOutput = m_ReadWriteJustNode(protoCmd->m_sInput, 3);
         break;
+    case JustAccuSample:
+        protoCmd->m_sOutput = m_AccuSample(protoCmd->m_sInput);
+        break;
+    case JustAccuStatistic:
+        protoCmd->m_sOutput = m_ReadAccuStatistic(protoCmd->m_sInput);
+        break;
+    case JustAccuCommit:
+        protoCmd->m_sOutput = m_AccuCommit(protoCmd->m_sInput);
+        break;
+    case JustAccuReset:
+        protoCmd->m_sOutput = m_AccuReset(protoCmd->m_sInput);
+        break;
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
@@ -132,7 +111,7 @@ QString cJustData::m_ReadWriteStatus(QString &sInput)
                     quint8 par = spar.toInt(&ok);
                     if (ok)
                     {
-                        m_nStatus = par;
+                        setStatus(par);
                         return SCPI::scpiAnswer[SCPI::ack];
                     }
                     else
@@ -173,6 +152,7 @@ QString cJustData::m_ReadWriteJustCoeeficient(QString &sInput, quint8 index)
                     if (ok)
                     {
                         setCoefficient(index, par);
+                        buildTable();
                         return SCPI::scpiAnswer[SCPI::ack];
                     }
                     else
@@ -247,11 +227,14 @@ void cJustData::Serialize(QDataStream& qds) // writes adjustment data to a qdata
 void cJustData::Deserialize(QDataStream& qds) // reads adjustment data from a qdatastream
 {
     int i;
-    qds >> m_nStatus;
+    quint8 stat;
+    qds >> stat;
+    setStatus(stat);
     for (i = 0; i < m_nOrder+1; i++)
         qds >> m_pCoefficient[i];
     for (i = 0; i < m_nOrder+1; i++)
         m_pJustNode[i].Deserialize(qds);
+    buildTable();
 }
 
 
@@ -285,7 +268,7 @@ QString cJustData::SerializeNodes()
 void cJustData::DeserializeStatus(const QString &s)
 {
     bool ok;
-    m_nStatus = s.toInt(&ok);
+    setStatus(s.toInt(&ok));
 }
 
 
@@ -294,6 +277,7 @@ void cJustData::DeserializeCoefficients(const QString& s)
     int i;
     for (i = 0; i < m_nOrder+1; i++)
         m_pCoefficient[i] = s.section(';',i,i).toDouble();
+    buildTable();
 }
 
 
@@ -305,6 +289,89 @@ void cJustData::DeserializeNodes(const QString& s)
 }
 
 
+QString cJustData::m_AccuSample(QString &sInput)
+{
+    cSCPICommand cmd = sInput;
+
+    // a batch of samples: corr0;arg0;corr1;arg1;...
+    // we check the whole batch before we take anything
+    QList<double> values;
+    for (int i = 0; cmd.getParam(i) != ""; i++)
+    {
+        bool ok;
+        values.append(cmd.getParam(i).toDouble(&ok));
+        if (!ok)
+            return SCPI::scpiAnswer[SCPI::errval];
+    }
+
+    if ( (values.count() == 0) || ((values.count() & 1) != 0) )
+        return SCPI::scpiAnswer[SCPI::nak];
+
+    for (int i = 0; i < values.count(); i += 2)
+        m_NodeAccumulator.addSample(values.at(i), values.at(i+1));
+
+    return SCPI::scpiAnswer[SCPI::ack];
+}
+
+
+QString cJustData::m_ReadAccuStatistic(QString &sInput)
+{
+    cSCPICommand cmd = sInput;
+
+    if (cmd.isQuery())
+        return m_NodeAccumulator.SerializeStatistic();
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cJustData::m_AccuCommit(QString &sInput)
+{
+    cSCPICommand cmd = sInput;
+
+    if (cmd.isCommand(1))
+    {
+        bool enable;
+        bool ok;
+        if (pAtmel->getEEPROMAccessEnable(enable) == cmddone)
+        {
+            if (enable)
+            {
+                int index = cmd.getParam(0).toInt(&ok);
+                if ( ok && (index >= 0) && (index < m_nOrder+1) && (m_NodeAccumulator.getCount() > 0) )
+                {
+                    setNode(index, m_NodeAccumulator.getNode()); // the averaged node
+                    m_NodeAccumulator.reset(); // ready for the next node
+                    return SCPI::scpiAnswer[SCPI::ack];
+                }
+                else
+                    return SCPI::scpiAnswer[SCPI::errval];
+            }
+            else
+                return SCPI::scpiAnswer[SCPI::erraut];
+        }
+        else
+            return SCPI::scpiAnswer[SCPI::errexec];
+    }
+
+    return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cJustData::m_AccuReset(QString &sInput)
+{
+    cSCPICommand cmd = sInput;
+
+    if (cmd.isCommand(0))
+    {
+        m_NodeAccumulator.reset();
+        return SCPI::scpiAnswer[SCPI::ack];
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
 bool cJustData::setNode(int index, cJustNode jn) // // !!! setting node sequence is relevant !!!
 {
     if (index < m_nOrder+1)
@@ -381,6 +448,8 @@ bool cJustData::cmpCoefficients() // calculates coefficients from nodes
     for (i = i; i < m_nOrder+1; i++)
 	setCoefficient(i, 0.0);
     delete Matrix;
+
+    buildTable();
     
     return true;
 }
@@ -392,15 +461,102 @@ quint8 cJustData::getStatus()
 }
 
 
+QVector<double> cJustData::getCoefficients()
+{
+    QVector<double> coeffs(m_nOrder+1);
+    for (int i = 0; i < m_nOrder+1; i++)
+        coeffs[i] = m_pCoefficient[i];
+    return coeffs;
+}
+
+
+void cJustData::setStatus(quint8 stat)
+{
+    bool wasJustified = ((m_nStatus & JustData::Justified) != 0);
+    bool isJustified = ((stat & JustData::Justified) != 0);
+
+    m_nStatus = stat;
+    if (wasJustified != isJustified)
+        emit notAdjustedChanged(isJustified ? -1 : 1);
+}
+
+
 void cJustData::initJustData(double init)
 {
     setNode(0 , cJustNode(init,0.0)); // setting the 1st node and all following
     cmpCoefficients();
-    m_nStatus = 0;
+    setStatus(0);
 }
 
     
 double cJustData::getCorrection(double arg) // calculates correction value
+{
+    if (m_nTableResolution > 0)
+    {
+        double pos = arg / m_fTableStep;
+        if ( (pos >= 0.0) && (pos < m_nTableResolution) )
+        {
+            int i = (int) pos;
+            double frac = pos - i;
+            return m_TableValues[i] + (m_TableValues[i+1] - m_TableValues[i]) * frac;
+        }
+    }
+
+    return cmpCorrection(arg);
+}
+
+
+void cJustData::setTable(quint16 resolution, double argmax)
+{
+    if ( (resolution > 0) && (argmax > 0.0) )
+    {
+        m_nTableResolution = resolution;
+        m_fTableArgMax = argmax;
+        m_fTableStep = argmax / resolution;
+    }
+    else
+    {
+        m_nTableResolution = 0;
+        m_fTableArgMax = 0.0;
+        m_fTableStep = 0.0;
+    }
+
+    buildTable();
+}
+
+
+quint16 cJustData::getTableResolution()
+{
+    return m_nTableResolution;
+}
+
+
+void cJustData::SerializeTable(QDataStream &qds)
+{
+    qds << m_nTableResolution;
+    qds << (float) m_fTableArgMax;
+    for (int i = 0; i < m_TableValues.count(); i++)
+        qds << (float) m_TableValues.at(i);
+}
+
+
+void cJustData::buildTable()
+{
+    if (m_nTableResolution == 0)
+        m_TableValues.clear();
+    else
+    {
+        m_TableValues.resize(m_nTableResolution+1); // resolution intervals -> resolution+1 grid points
+        for (int i = 0; i < m_nTableResolution; i++)
+            m_TableValues[i] = cmpCorrection(i * m_fTableStep);
+        m_TableValues[m_nTableResolution] = cmpCorrection(m_fTableArgMax);
+    }
+
+    emit coefficientsChanged(); // we get called for every change of our coefficients
+}
+
+
+double cJustData::cmpCorrection(double arg)
 {
     double Arg = 1.0;
     double Corr = 0.0;
@@ -1,7 +1,10 @@
 #ifndef JUSTDATA_H
 #define JUSTDATA_H
 
+#include <QVector>
+
 #include "scpiconnection.h"
+#include "nodeaccumulator.h"
 
 class QDataStream; // forward
 class QString;
@@ -22,7 +25,11 @@ enum JustCommands
     JustNode0,
     JustNode1,
     JustNode2,
-    JustNode3
+    JustNode3,
+    JustAccuSample,
+    JustAccuStatistic,
+    JustAccuCommit,
+    JustAccuReset
 };
 
 
@@ -39,6 +46,8 @@ class cJustNode;
 
 class cJustData: public cSCPIConnection // base class for adjustment coefficients and nodes
 {
+    Q_OBJECT
+
 public:
     cJustData(cSCPI *scpiinterface, int order, double init);
     ~cJustData();
@@ -56,20 +65,44 @@ public:
     double getCorrection(double arg); // calculates correction value c= ax^order +bx^order-1 ...
     bool cmpCoefficients(); // calculates coefficients from nodes
     quint8 getStatus();
+    QVector<double> getCoefficients(); // index is the power of the argument
     void initJustData(double init); // for initialization of justdata
 
+    // optional lookup table, resolution intervals over 0..argmax, resolution 0 switches it off
+    // if set, getCorrection interpolates linear within the table and falls back to the polynom outside
+    void setTable(quint16 resolution, double argmax);
+    quint16 getTableResolution();
+    void SerializeTable(QDataStream& qds); // table values as single precision floats
+
+signals:
+    void notAdjustedChanged(int delta); // +1 if we lost the justified bit, -1 if we got it
+    void coefficientsChanged();
+
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
 private:
     quint8 m_nStatus;
+    void setStatus(quint8 stat); // all status changes go here, so our owners can count instead of polling
     double* m_pCoefficient; // size of data depends on order
     cJustNode* m_pJustNode; // same
     int m_nOrder; // we notice order
+    quint16 m_nTableResolution; // 0 = no table
+    double m_fTableArgMax;
+    double m_fTableStep;
+    QVector<double> m_TableValues;
+    cNodeAccumulator m_NodeAccumulator; // averages node samples sent by the adjustment tool
+
+    double cmpCorrection(double arg); // the polynom itself
+    void buildTable(); // must be called whenever coefficients change
 
     QString m_ReadWriteStatus(QString& sInput);
     QString m_ReadWriteJustCoeeficient(QString& sInput, quint8 index);
     QString m_ReadWriteJustNode(QString& sInput, quint8 index);
+    QString m_AccuSample(QString& sInput);
+    QString m_ReadAccuStatistic(QString& sInput);
+    QString m_AccuCommit(QString& sInput);
+    QString m_AccuReset(QString& sInput);
 
     bool setNode(int index, cJustNode jn); // !!! setting node sequence is relevant !!!
     cJustNode* getNode(int index); // can be read back
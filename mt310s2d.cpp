@@ -38,6 +38,7 @@
 #include "scheadinterface.h"
 #include "hkeyinterface.h"
 #include "clampinterface.h"
+#include "jobinterface.h"
 #include "atmel.h"
 #include "atmelwatcher.h"
 #include "adjustment.h"
@@ -81,6 +82,7 @@ cMT310S2dServer::cMT310S2dServer(QObject *parent)
     m_pSystemInterface = 0;
     m_pSenseInterface = 0;
     m_pClampInterface = 0;
+    m_pJobInterface = 0;
     m_pSystemInfo = 0;
     m_pAdjHandler = 0;
     m_pRMConnection = 0;
@@ -138,6 +140,7 @@ cMT310S2dServer::~cMT310S2dServer()
     if (pAtmel) delete pAtmel;
     if (m_pAtmelWatcher) delete m_pAtmelWatcher;
     if (m_pStatusInterface) delete m_pStatusInterface;
+    if (m_pJobInterface) delete m_pJobInterface; // jobs still refer to the interfaces below
     if (m_pSystemInterface) delete m_pSystemInterface;
     if (m_pSenseInterface) delete m_pSenseInterface;
     if (m_pClampInterface) delete m_pClampInterface;
@@ -391,6 +394,7 @@ void cMT310S2dServer::doSetupServer()
             scpiConnectionList.append(m_pSCHeadInterface = new cSCHeadInterface(this));
             scpiConnectionList.append(m_pHKeyInterface = new cHKeyInterface(this));
             scpiConnectionList.append(m_pClampInterface = new cClampInterface(this, pAtmel));
+            scpiConnectionList.append(m_pJobInterface = new cJobInterface(this));
 
             resourceList.append(m_pSenseInterface); // all our resources
             resourceList.append(m_pSamplingInterface);
@@ -401,9 +405,15 @@ void cMT310S2dServer::doSetupServer()
 
 
             m_pAdjHandler->addAdjFlashObject(m_pSenseInterface);
+            // status changes are pushed to the status interface, STATUS:ADJUSTMENT? only returns the actual value
+            connect(m_pSenseInterface, SIGNAL(adjustmentStatusChanged()), m_pStatusInterface, SLOT(setNotifierAdjustment()));
+            m_pStatusInterface->setNotifierAdjustment();
             m_pSenseInterface->importAdjFlash(); // we read adjustmentdata at least once
+            // attached or detached clamps change our scpi model, SYSTEM:INTERFACE:READ? is exported again then
+            connect(m_pClampInterface, SIGNAL(clampsChanged()), m_pSystemInterface, SLOT(scpiModelChanged()));
 
             initSCPIConnections();
+            m_pSystemInterface->scpiModelChanged(); // all static commands are in the model now
 
             // after init. we once poll the clampstatus because we don't get an interrupt if clamp was already connected on power up
             m_pClampInterface->actualizeClampStatus();
@@ -24,6 +24,7 @@ class cAtmelWatcher;
 class cRMConnection;
 class QSocketNotifier;
 class cClampInterface;
+class cJobInterface;
 
 class cMT310S2dServer: public cPCBServer
 {
@@ -45,6 +46,7 @@ public:
     cAdjustment* m_pAdjHandler;
     cRMConnection* m_pRMConnection;
     cClampInterface* m_pClampInterface;
+    cJobInterface* m_pJobInterface;
 
     int DevFileDescriptorCtrl; // kerneltreiber wird nur 1x geöffnet und dann gehalten
     int DevFileDescriptorMsg;
@@ -31,6 +31,7 @@ HEADERS	+= \
     ethsettings.h \
     fpgasettings.h \
     justnode.h \
+    nodeaccumulator.h \
     scpidelegate.h \
     statusinterface.h \
     scpiconnection.h \
@@ -56,6 +57,9 @@ HEADERS	+= \
     systeminfo.h \
     rmconnection.h \
     notificationstring.h \
+    uploadbuffer.h \
+    job.h \
+    jobinterface.h \
     notificationdata.h \
     protonetcommand.h \
     fpzinchannel.h \
@@ -68,6 +72,11 @@ HEADERS	+= \
     clamp.h \
     ctrlsettings.h \
     clampinterface.h \
+    clampreader.h \
+    clampmux.h \
+    scpirouter.h \
+    parsedcommand.h \
+    sharedread.h \
     mt310s2d.h \
     mt310s2dglobal.h \
     mt310s2dprotobufwrapper.h \
@@ -84,6 +93,7 @@ SOURCES	+= \
     ethsettings.cpp \
     fpgasettings.cpp \
     justnode.cpp \
+    nodeaccumulator.cpp \
     scpidelegate.cpp \
     statusinterface.cpp \
     scpiconnection.cpp \
@@ -106,6 +116,9 @@ SOURCES	+= \
     resource.cpp \
     rmconnection.cpp \
     notificationstring.cpp \
+    uploadbuffer.cpp \
+    job.cpp \
+    jobinterface.cpp \
     protonetcommand.cpp \
     fpzinchannel.cpp \
     frqinputinterface.cpp \
@@ -119,6 +132,11 @@ SOURCES	+= \
     adjxml.cpp \
     ctrlsettings.cpp \
     clampinterface.cpp \
+    clampreader.cpp \
+    clampmux.cpp \
+    scpirouter.cpp \
+    parsedcommand.cpp \
+    sharedread.cpp \
     mt310s2d.cpp \
     mt310s2dprotobufwrapper.cpp \
     mt310s2justdata.cpp \
@@ -32,6 +32,7 @@ enum DebugLevel {NoDebug, DebugLevel1, DebugLevel2, DebugLevel3 = 4, MaxDebugLev
 #define defaultI2CClampFlashAdr 0x51
 #define defaultXSDFile "/etc/zera/mt310s2d/mt310s2d.xsd"
 #define atmelFlashfilePath "/opt/zera/bin/atmel-mt310s2.hex"
+#define adjCachePath "/var/lib/zera/mt310s2d" // local copies of the eeprom adjustment images
 #define atmelResetBit 16
 #define defaultTMaxAtmel 10000
 
@@ -1,12 +1,12 @@
 // implemention cMT310S2JustData
 
 #include <qdatastream.h>
+#include <QByteArray>
 #include <scpi.h>
 
 #include "protonetcommand.h"
 #include "atmel.h"
 #include "justdata.h"
-#include "scpidelegate.h"
 #include "mt310s2justdata.h"
 
 extern cATMEL* pAtmel;
@@ -14,10 +14,23 @@ extern cATMEL* pAtmel;
 cMT310S2JustData::cMT310S2JustData(cSCPI *scpiinterface)
 {
     m_pSCPIInterface = scpiinterface;
+    m_nTableResolution = 0; // no lookup table by default
+    m_fTableArgMax = 0.0;
 
     m_pGainCorrection = new cJustData(m_pSCPIInterface, GainCorrOrder, 1.0);
     m_pPhaseCorrection = new cJustData(m_pSCPIInterface, PhaseCorrOrder, 0.0);
     m_pOffsetCorrection =  new cJustData(m_pSCPIInterface, OffsetCorrOrder, 0.0);
+
+    // we count our corrections without justified bit and only get told about changes
+    m_nNotAdjusted = 0;
+    cJustData* corrections[3] = {m_pGainCorrection, m_pPhaseCorrection, m_pOffsetCorrection};
+    for (int i = 0; i < 3; i++)
+    {
+        if ((corrections[i]->getStatus() & JustData::Justified) == 0)
+            m_nNotAdjusted++;
+        connect(corrections[i], SIGNAL(notAdjustedChanged(int)), this, SLOT(correctionAdjustmentChanged(int)));
+        connect(corrections[i], SIGNAL(coefficientsChanged()), this, SIGNAL(coefficientsChanged()));
+    }
 }
 
 
@@ -31,44 +44,13 @@ cMT310S2JustData::~cMT310S2JustData()
 
 void cMT310S2JustData::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
+    // our commands are routed by the sense interface
 
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "GAIN", SCPI::CmdwP , m_pSCPIInterface, DirectGain);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "ADJGAIN", SCPI::CmdwP , m_pSCPIInterface, DirectJustGain);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "PHASE", SCPI::isCmdwP, m_pSCPIInterface, DirectPhase);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "ADJPHASE", SCPI::isCmdwP, m_pSCPIInterface, DirectJustPhase);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "OFFSET", SCPI::isCmdwP, m_pSCPIInterface, DirectOffset);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "ADJOFFSET", SCPI::isCmdwP, m_pSCPIInterface, DirectJustOffset);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "STATUS", SCPI::isQuery, m_pSCPIInterface, DirectJustStatus);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "COMPUTE", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, DirectJustCompute);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1CORRECTION").arg(leadingNodes), "INIT", SCPI::isCmdwP || SCPI::isQuery, m_pSCPIInterface, DirectJustInit);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-
-    connect(m_pGainCorrection, SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
     m_pGainCorrection->initSCPIConnection(QString("%1CORRECTION:GAIN").arg(leadingNodes));
-    connect(m_pPhaseCorrection, SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
     m_pPhaseCorrection->initSCPIConnection(QString("%1CORRECTION:PHASE").arg(leadingNodes));
-    connect(m_pOffsetCorrection, SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
     m_pOffsetCorrection->initSCPIConnection(QString("%1CORRECTION:OFFSET").arg(leadingNodes));
 }
 	    
@@ -104,10 +86,16 @@ void cMT310S2JustData::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     case DirectJustInit:
         protoCmd->m_sOutput = m_InitJustData(protoCmd->m_sInput);
         break;
+    case DirectJustTable:
+        protoCmd->m_sOutput = m_ReadTable(protoCmd->m_sInput);
+        break;
+    case DirectJustTableResolution:
+        protoCmd->m_sOutput = m_ReadWriteTableResolution(protoCmd->m_sInput);
+        break;
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
@@ -295,6 +283,69 @@ QString cMT310S2JustData::m_InitJustData(QString &sInput)
 }
 
 
+QString cMT310S2JustData::m_ReadTable(QString &sInput)
+{
+    cSCPICommand cmd = sInput;
+
+    if (cmd.isQuery())
+    {
+        // version, then resolution, argmax and values for gain, phase and offset. phase has no table (resolution 0)
+        QByteArray ba;
+        QDataStream stream(&ba, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_4);
+        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+        stream << CorrTableVersion;
+        m_pGainCorrection->SerializeTable(stream);
+        m_pPhaseCorrection->SerializeTable(stream);
+        m_pOffsetCorrection->SerializeTable(stream);
+
+        return QString(ba.toBase64());
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cMT310S2JustData::m_ReadWriteTableResolution(QString &sInput)
+{
+    bool ok;
+    cSCPICommand cmd = sInput;
+
+    if (cmd.isQuery())
+        return QString("%1").arg(m_nTableResolution);
+    else
+    {
+        if (cmd.isCommand(1))
+        {
+            QString spar = cmd.getParam(0);
+            quint16 par = spar.toUShort(&ok);
+            // a range without upper value (argmax 0) can't have a table, only 0 is accepted then
+            if (ok && (par <= MaxCorrTableResolution) && ((par == 0) || (m_fTableArgMax > 0.0)))
+            {
+                // the table changes what all clients get from CORRECTION:GAIN? and OFFSET?
+                bool enable;
+                if (pAtmel->getEEPROMAccessEnable(enable) != cmddone)
+                    return SCPI::scpiAnswer[SCPI::errexec];
+                if (!enable)
+                    return SCPI::scpiAnswer[SCPI::erraut];
+
+                // gain and offset depend on the amplitude, so their tables cover the range. phase
+                // depends on the frequency, it always uses its polynom
+                m_nTableResolution = par;
+                m_pGainCorrection->setTable(m_nTableResolution, m_fTableArgMax);
+                m_pOffsetCorrection->setTable(m_nTableResolution, m_fTableArgMax);
+                return SCPI::scpiAnswer[SCPI::ack];
+            }
+            else
+                return SCPI::scpiAnswer[SCPI::errval];
+        }
+    }
+
+    return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
 double cMT310S2JustData::getGainCorrection(double par)
 {
     return m_pGainCorrection->getCorrection(par);
@@ -354,6 +405,43 @@ quint8 cMT310S2JustData::getAdjustmentStatus()
 }
 
 
+int cMT310S2JustData::getNotAdjustedCount()
+{
+    return m_nNotAdjusted;
+}
+
+
+void cMT310S2JustData::SerializeCoefficients(QDataStream &qds)
+{
+    qds << getGainCoefficients() << getPhaseCoefficients() << getOffsetCoefficients();
+}
+
+
+QVector<double> cMT310S2JustData::getGainCoefficients()
+{
+    return m_pGainCorrection->getCoefficients();
+}
+
+
+QVector<double> cMT310S2JustData::getPhaseCoefficients()
+{
+    return m_pPhaseCorrection->getCoefficients();
+}
+
+
+QVector<double> cMT310S2JustData::getOffsetCoefficients()
+{
+    return m_pOffsetCorrection->getCoefficients();
+}
+
+
+void cMT310S2JustData::correctionAdjustmentChanged(int delta)
+{
+    m_nNotAdjusted += delta;
+    emit notAdjustedChanged(delta);
+}
+
+
 void cMT310S2JustData::initJustData()
 {
     m_pGainCorrection->initJustData(1.0);
@@ -370,3 +458,9 @@ void cMT310S2JustData::computeJustData()
 }
 
 
+void cMT310S2JustData::setTableArgMax(double argmax)
+{
+    m_fTableArgMax = argmax;
+}
+
+
@@ -4,6 +4,7 @@
 #define MT310S2JUSTDATA_H
 
 #include <QObject>
+#include <QVector>
 #include "scpiconnection.h"
 
 enum DirectJustCommands
@@ -16,7 +17,9 @@ enum DirectJustCommands
     DirectJustOffset,
     DirectJustStatus,
     DirectJustCompute,
-    DirectJustInit
+    DirectJustInit,
+    DirectJustTable,
+    DirectJustTableResolution
 };
 
 
@@ -24,6 +27,9 @@ const int GainCorrOrder = 3; // ax^3 + bx^2 + cx + d
 const int PhaseCorrOrder  = 3;
 const int OffsetCorrOrder = 3;
 
+const quint8 CorrTableVersion = 1; // format version of the correction table blob
+const quint16 MaxCorrTableResolution = 4096;
+
 
 class QDataStream;
 class cJustData;
@@ -45,12 +51,27 @@ public:
     void Serialize(QDataStream&); // zum schreiben aller justagedaten in flashspeicher
     void Deserialize(QDataStream&); // zum lesen aller justagedaten aus flashspeicher
     quint8 getAdjustmentStatus();
+    int getNotAdjustedCount(); // number of our corrections without justified bit, 0 means adjusted
+    void SerializeCoefficients(QDataStream& qds); // effective gain, phase and offset coefficients
+
+    // effective correction polynoms, index is the power of the argument. cascaded ranges return the combined polynom
+    virtual QVector<double> getGainCoefficients();
+    virtual QVector<double> getPhaseCoefficients();
+    virtual QVector<double> getOffsetCoefficients();
     void initJustData();
     void computeJustData();
+    void setTableArgMax(double argmax); // upper argument of the lookup tables, the range knows it
+
+signals:
+    void notAdjustedChanged(int delta);
+    void coefficientsChanged();
 
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
+private slots:
+    void correctionAdjustmentChanged(int delta);
+
 protected:
     QString mReadGainCorrection(QString&sInput);
     QString mReadJustGainCorrection(QString&sInput);
@@ -61,6 +82,8 @@ protected:
     QString m_ReadStatus(QString& sInput);
     QString m_ComputeJustData(QString& sInput);
     QString m_InitJustData(QString& sInput);
+    QString m_ReadTable(QString& sInput);
+    QString m_ReadWriteTableResolution(QString& sInput);
 
     virtual double getGainCorrection(double par);
     virtual double getJustGainCorrection(double par);
@@ -68,6 +91,11 @@ protected:
     virtual double getJustPhaseCorrection(double par);
     virtual double getOffsetCorrection(double par);
     virtual double getJustOffsetCorrection(double par);
+
+private:
+    quint16 m_nTableResolution;
+    double m_fTableArgMax;
+    int m_nNotAdjusted;
 };
 
 
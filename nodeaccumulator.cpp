@@ -0,0 +1,148 @@
+#include <QString>
+#include <math.h>
+#include <algorithm>
+
+#include "justnode.h"
+#include "nodeaccumulator.h"
+
+
+cNodeAccumulator::cNodeAccumulator()
+{
+    reset();
+}
+
+
+void cNodeAccumulator::addSample(double corr, double arg)
+{
+    if (!m_bScreened)
+    {
+        // the statistic includes them already, it is corrected once we can judge them
+        m_FirstCorrections.append(corr);
+        m_FirstArguments.append(arg);
+        addToStatistic(corr, arg);
+        if (m_FirstCorrections.count() >= AccuMinSamplesOutlier)
+            screenFirstSamples();
+        return;
+    }
+
+    double sigma = getStdDeviation();
+    if ( (sigma > 0.0) && (fabs(corr - m_fMeanCorrection) > AccuOutlierSigma * sigma) )
+    {
+        m_nOutliers++;
+        return;
+    }
+
+    addToStatistic(corr, arg);
+}
+
+
+void cNodeAccumulator::reset()
+{
+    m_bScreened = false;
+    m_FirstCorrections.clear();
+    m_FirstArguments.clear();
+    m_nOutliers = 0;
+    resetStatistic();
+}
+
+
+void cNodeAccumulator::addToStatistic(double corr, double arg)
+{
+    m_nCount++;
+    double delta = corr - m_fMeanCorrection;
+    m_fMeanCorrection += delta / m_nCount;
+    m_fM2 += delta * (corr - m_fMeanCorrection);
+    m_fMeanArgument += (arg - m_fMeanArgument) / m_nCount;
+
+    if ( (m_nCount == 1) || (corr < m_fMinCorrection) )
+        m_fMinCorrection = corr;
+    if ( (m_nCount == 1) || (corr > m_fMaxCorrection) )
+        m_fMaxCorrection = corr;
+}
+
+
+void cNodeAccumulator::resetStatistic()
+{
+    m_nCount = 0;
+    m_fMeanCorrection = 0.0;
+    m_fM2 = 0.0;
+    m_fMeanArgument = 0.0;
+    m_fMinCorrection = 0.0;
+    m_fMaxCorrection = 0.0;
+}
+
+
+static double median(QVector<double> values) // values must not be empty
+{
+    std::sort(values.begin(), values.end());
+    int n = values.count();
+    if (n % 2)
+        return values.at(n/2);
+    return (values.at(n/2 - 1) + values.at(n/2)) / 2.0;
+}
+
+
+void cNodeAccumulator::screenFirstSamples()
+{
+    double med = median(m_FirstCorrections);
+
+    QVector<double> deviations;
+    for (int i = 0; i < m_FirstCorrections.count(); i++)
+        deviations.append(fabs(m_FirstCorrections.at(i) - med));
+    double sigma = AccuMADSigma * median(deviations); // robust, up to half of the samples may be outliers
+
+    resetStatistic();
+    for (int i = 0; i < m_FirstCorrections.count(); i++)
+    {
+        // like later on, without spread we can't judge
+        if ( (sigma > 0.0) && (deviations.at(i) > AccuOutlierSigma * sigma) )
+            m_nOutliers++;
+        else
+            addToStatistic(m_FirstCorrections.at(i), m_FirstArguments.at(i));
+    }
+
+    m_FirstCorrections.clear();
+    m_FirstArguments.clear();
+    m_bScreened = true;
+}
+
+
+quint32 cNodeAccumulator::getCount()
+{
+    return m_nCount;
+}
+
+
+quint32 cNodeAccumulator::getOutliers()
+{
+    return m_nOutliers;
+}
+
+
+double cNodeAccumulator::getStdDeviation()
+{
+    if (m_nCount < 2)
+        return 0.0;
+
+    return sqrt(m_fM2 / (m_nCount - 1)); // sample variance
+}
+
+
+cJustNode cNodeAccumulator::getNode()
+{
+    return cJustNode(m_fMeanCorrection, m_fMeanArgument);
+}
+
+
+QString cNodeAccumulator::SerializeStatistic()
+{
+    QString s;
+    s = QString("%1;%2;%3;%4;%5;%6;%7;").arg(m_nCount)
+                                        .arg(m_fMeanCorrection,0,'f',9)
+                                        .arg(getStdDeviation(),0,'e',6)
+                                        .arg(m_fMeanArgument,0,'f',6)
+                                        .arg(m_fMinCorrection,0,'f',9)
+                                        .arg(m_fMaxCorrection,0,'f',9)
+                                        .arg(m_nOutliers);
+    return s;
+}
@@ -0,0 +1,47 @@
+#ifndef NODEACCUMULATOR_H
+#define NODEACCUMULATOR_H
+
+#include <QString>
+#include <QVector>
+
+#include "justnode.h"
+
+// collects (correction, argument) samples for 1 adjustment node on the server side
+// we keep running mean and variance (welford) so the client doesn't have to average itself.
+// the first samples are screened against their median once we have enough of them, so a gross
+// outlier among them can't inflate the variance. later ones are judged against mean and sigma
+
+const int AccuMinSamplesOutlier = 5; // we need some samples before we can judge
+const double AccuOutlierSigma = 4.0; // samples beyond this many standard deviations are outliers
+const double AccuMADSigma = 1.4826; // median absolute deviation -> standard deviation (normal distribution)
+
+class cNodeAccumulator
+{
+public:
+    cNodeAccumulator();
+    void addSample(double corr, double arg);
+    void reset();
+    quint32 getCount(); // samples in use, outliers not included
+    quint32 getOutliers();
+    double getStdDeviation();
+    cJustNode getNode(); // mean correction and mean argument
+    QString SerializeStatistic(); // count;mean;stddev;argument;min;max;outliers;
+
+private:
+    void addToStatistic(double corr, double arg);
+    void resetStatistic();
+    void screenFirstSamples(); // median and mad over the first samples, the statistic is built again from the good ones
+
+    bool m_bScreened; // the first samples are judged
+    QVector<double> m_FirstCorrections; // kept until then
+    QVector<double> m_FirstArguments;
+    quint32 m_nCount;
+    quint32 m_nOutliers;
+    double m_fMeanCorrection;
+    double m_fM2; // sum of squared deviations from the mean
+    double m_fMeanArgument;
+    double m_fMinCorrection;
+    double m_fMaxCorrection;
+};
+
+#endif // NODEACCUMULATOR_H
@@ -0,0 +1,112 @@
+#include "parsedcommand.h"
+
+
+cParsedCommand::cParsedCommand()
+    :m_bQuery(false)
+{
+}
+
+
+void cParsedCommand::parse(const QString *input)
+{
+    int len = input->length();
+    int pos = 0;
+    int start;
+
+    m_NodeList.clear();
+    m_ParamList.clear();
+    m_RawParam = QStringRef();
+    m_bQuery = false;
+
+    while (pos < len && input->at(pos) == ' ')
+        pos++;
+
+    // the header nodes up to the first blank
+    start = pos;
+    while (pos < len && input->at(pos) != ' ')
+    {
+        if (input->at(pos) == ':')
+        {
+            if (pos > start)
+                m_NodeList.append(QStringRef(input, start, pos - start));
+            start = pos + 1;
+        }
+        pos++;
+    }
+
+    int end = pos;
+    if (end > start && input->at(end-1) == '?')
+    {
+        m_bQuery = true;
+        end--;
+    }
+    if (end > start)
+        m_NodeList.append(QStringRef(input, start, end - start));
+
+    // the parameter text as it was sent, for data that may contain ; or blanks itself
+    if (pos < len)
+    {
+        int rawLen = len - pos - 1;
+        if (rawLen > 0 && input->at(len-1) == ';')
+            rawLen--;
+        m_RawParam = QStringRef(input, pos + 1, rawLen);
+    }
+
+    // then the parameters separated by ;, a blank or a trailing ; alone gives no parameter
+    while (pos < len)
+    {
+        pos++;
+        start = pos;
+        while (pos < len && input->at(pos) != ';')
+            pos++;
+
+        QStringRef param = QStringRef(input, start, pos - start).trimmed();
+        if (param.length() > 0 || pos < len)
+            m_ParamList.append(param);
+    }
+}
+
+
+bool cParsedCommand::isQuery(int nParams) const
+{
+    return m_bQuery && (m_ParamList.count() == nParams);
+}
+
+
+bool cParsedCommand::isCommand(int nParams) const
+{
+    return !m_bQuery && (m_ParamList.count() == nParams);
+}
+
+
+int cParsedCommand::getNodeCount() const
+{
+    return m_NodeList.count();
+}
+
+
+QStringRef cParsedCommand::getNode(int i) const
+{
+    return m_NodeList.at(i);
+}
+
+
+int cParsedCommand::getParamCount() const
+{
+    return m_ParamList.count();
+}
+
+
+QStringRef cParsedCommand::getParam(int i) const
+{
+    if (i < m_ParamList.count())
+        return m_ParamList.at(i);
+
+    return QStringRef();
+}
+
+
+QStringRef cParsedCommand::getRawParam() const
+{
+    return m_RawParam;
+}
@@ -0,0 +1,35 @@
+#ifndef PARSEDCOMMAND_H
+#define PARSEDCOMMAND_H
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+// a command is parsed once when it is dispatched. nodes and parameters are views into the
+// command's input, so handlers can look at them without any further copies. the input
+// string must neither be changed nor moved while a parsed command refers to it.
+// "HEADER ;" gives 1 empty parameter like it did with cSCPICommand, the legacy form
+// of commands without parameter
+
+class cParsedCommand
+{
+public:
+    cParsedCommand();
+    void parse(const QString* input);
+
+    bool isQuery(int nParams = 0) const; // header ends with ? and nParams parameters follow
+    bool isCommand(int nParams) const; // no ? and nParams parameters follow
+    int getNodeCount() const;
+    QStringRef getNode(int i) const;
+    int getParamCount() const;
+    QStringRef getParam(int i) const; // empty past the last parameter
+    QStringRef getRawParam() const; // all behind the header blank, untrimmed, 1 terminating ; removed
+
+private:
+    QVector<QStringRef> m_NodeList;
+    QVector<QStringRef> m_ParamList;
+    QStringRef m_RawParam;
+    bool m_bQuery;
+};
+
+#endif // PARSEDCOMMAND_H
@@ -17,10 +17,18 @@
 #include "protonetcommand.h"
 #include "resource.h"
 #include "scpiconnection.h"
+#include "scpirouter.h"
 #include "pcbserver.h"
 #include "ethsettings.h"
 #include "mt310s2dglobal.h"
 
+static const cSCPIDelegateDescriptor ServerCommands[] =
+{
+    { "SERVER", "REGISTER",   SCPI::isCmdwP,               PCBServer::cmdRegister },
+    { "SERVER", "UNREGISTER", SCPI::isQuery | SCPI::isCmd, PCBServer::cmdUnregister },
+};
+
+
 cPCBServer::cPCBServer(QObject *parent)
     : cSCPIConnection(parent)
 {
@@ -33,17 +41,10 @@ cPCBServer::cPCBServer(QObject *parent)
 
 void cPCBServer::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1SERVER").arg(leadingNodes),"REGISTER",SCPI::isCmdwP, m_pSCPIInterface, PCBServer::cmdRegister);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SERVER").arg(leadingNodes),"UNREGISTER",SCPI::isQuery | SCPI::isCmd , m_pSCPIInterface, PCBServer::cmdUnregister);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, ServerCommands);
 
 }
 
@@ -54,6 +55,12 @@ cSCPI *cPCBServer::getSCPIInterface()
 }
 
 
+cSCPIRouter *cPCBServer::getSCPIRouter()
+{
+    return m_pSCPIRouter;
+}
+
+
 quint32 cPCBServer::getMsgNr()
 {
     m_nMsgNr++;
@@ -78,6 +85,7 @@ QString &cPCBServer::getVersion()
 void cPCBServer::setupServer()
 {
     m_pSCPIInterface = new cSCPI(m_sServerName); // our scpi interface
+    m_pSCPIRouter = new cSCPIRouter(); // and the parametric commands
     myServer = new XiQNetServer(this); // our working (talking) horse
     myServer->setDefaultWrapper(&m_ProtobufWrapper);
     connect(myServer,SIGNAL(sigClientConnected(XiQNetPeer*)),this,SLOT(establishNewConnection(XiQNetPeer*)));
@@ -105,7 +113,7 @@ void cPCBServer::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        sendAnswer(protoCmd);
 }
 
 
@@ -220,7 +228,7 @@ void cPCBServer::SCPIInput()
     m_sInput.remove('\n');
 
     QByteArray clientId = QByteArray(); // we set an empty byte array
-    cProtonetCommand* protoCmd = new cProtonetCommand(0, false, true, clientId, 0, m_sInput);
+    cProtonetCommand* protoCmd = new cProtonetCommand(0, false, true, clientId, 0, m_sInput, this);
     // peer = 0 means we are working on the scpi socket ....
 
     if ( (scpiObject =  m_pSCPIInterface->getSCPIObject(m_sInput, dummy)) != 0)
@@ -229,13 +237,14 @@ void cPCBServer::SCPIInput()
         if (!scpiDelegate->executeSCPI(protoCmd))
         {
             protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
-            emit cmdExecutionDone(protoCmd);
+            sendAnswer(protoCmd);
         }
     }
     else
+    if (!m_pSCPIRouter->executeSCPI(protoCmd))
     {
         protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
-        emit cmdExecutionDone(protoCmd);
+        sendAnswer(protoCmd);
     }
 }
 
@@ -271,6 +280,7 @@ void cPCBServer::m_RegisterNotifier(cProtonetCommand *protoCmd)
             cProtonetCommand* procmd = new cProtonetCommand(protoCmd);
             procmd->m_bwithOutput = false;
             procmd->m_sInput = query;
+            procmd->m_Parsed.parse(&procmd->m_sInput);
 
             if (!scpiDelegate->executeSCPI(procmd))
             {
@@ -354,7 +364,7 @@ void cPCBServer::executeCommand(std::shared_ptr<google::protobuf::Message> cmd)
             if (protobufCommand->has_netcommand())
             {
                 // in case of "lost" clients we delete registration for notification
-                cProtonetCommand* protoCmd = new cProtonetCommand(peer, true, true, clientId, 0, "");
+                cProtonetCommand* protoCmd = new cProtonetCommand(peer, true, true, clientId, 0, "", this);
                 doUnregisterNotifier(protoCmd);
             }
 
@@ -365,20 +375,21 @@ void cPCBServer::executeCommand(std::shared_ptr<google::protobuf::Message> cmd)
                 quint32 messageNr = protobufCommand->messagenr();
                 ProtobufMessage::NetMessage::ScpiCommand scpiCmd = protobufCommand->scpi();
                 m_sInput = QString::fromStdString(scpiCmd.command()) +  " " + QString::fromStdString(scpiCmd.parameter());
-                cProtonetCommand* protoCmd = new cProtonetCommand(peer, true, true, clientId, messageNr, m_sInput);
+                cProtonetCommand* protoCmd = new cProtonetCommand(peer, true, true, clientId, messageNr, m_sInput, this);
                 if ( (scpiObject =  m_pSCPIInterface->getSCPIObject(m_sInput, dummy)) != 0)
                 {
                     cSCPIDelegate* scpiDelegate = static_cast<cSCPIDelegate*>(scpiObject);
                     if (!scpiDelegate->executeSCPI(protoCmd))
                     {
                         protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
-                        emit cmdExecutionDone(protoCmd);
+                        sendAnswer(protoCmd);
                     }
                 }
                 else
+                if (!m_pSCPIRouter->executeSCPI(protoCmd))
                 {
                     protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
-                    emit cmdExecutionDone(protoCmd);
+                    sendAnswer(protoCmd);
                 }
 
                 // we get a signal when a command is finished and send answer then
@@ -390,7 +401,7 @@ void cPCBServer::executeCommand(std::shared_ptr<google::protobuf::Message> cmd)
         {
             m_sInput =  QString::fromStdString(protobufCommand->scpi().command());
             QByteArray clientId = QByteArray(); // we set an empty byte array
-            cProtonetCommand* protoCmd = new cProtonetCommand(peer, false, true, clientId, 0, m_sInput);
+            cProtonetCommand* protoCmd = new cProtonetCommand(peer, false, true, clientId, 0, m_sInput, this);
             if ( (scpiObject =  m_pSCPIInterface->getSCPIObject(m_sInput, dummy)) != 0)
             {
                 cSCPIDelegate* scpiDelegate = static_cast<cSCPIDelegate*>(scpiObject);
@@ -398,14 +409,15 @@ void cPCBServer::executeCommand(std::shared_ptr<google::protobuf::Message> cmd)
                 if (!scpiDelegate->executeSCPI(protoCmd))
                 {
                     protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
-                    emit cmdExecutionDone(protoCmd);
+                    sendAnswer(protoCmd);
                 }
 
             }
             else
+            if (!m_pSCPIRouter->executeSCPI(protoCmd))
             {
                 protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
-                emit cmdExecutionDone(protoCmd);
+                sendAnswer(protoCmd);
             }
         }
     }
@@ -477,7 +489,6 @@ void cPCBServer::initSCPIConnections()
     {
         scpiConnectionList.at(i)->initSCPIConnection(""); // we have our interface
         connect(scpiConnectionList.at(i), SIGNAL(notifier(cNotificationString*)), this, SLOT(establishNewNotifier(cNotificationString*)));
-        connect(scpiConnectionList.at(i), SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SLOT(sendAnswer(cProtonetCommand*)));
     }
 }
 
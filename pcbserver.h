@@ -14,6 +14,7 @@
 #include "scpiconnection.h"
 #include "notificationstring.h"
 #include "notificationdata.h"
+#include "protonetcommand.h"
 
 class QTcpSocket;
 class QByteArray;
@@ -52,6 +53,7 @@ class QTcpServer;
 class QTcpSocket;
 class XiQNetPeer;
 class cSCPI;
+class cSCPIRouter;
 class cStatusInterface;  // forward
 class cDebugSettings;
 class cFPGASettings;
@@ -83,7 +85,7 @@ class cSourceSettings;
   */
 
 
-class cPCBServer: public cSCPIConnection
+class cPCBServer: public cSCPIConnection, public cAnswerHandler
 {
     Q_OBJECT
 
@@ -95,6 +97,7 @@ public:
     explicit cPCBServer(QObject* parent=0);
     virtual void initSCPIConnection(QString leadingNodes);
     cSCPI* getSCPIInterface();
+    cSCPIRouter* getSCPIRouter();
     quint32 getMsgNr();
 
     /**
@@ -132,6 +135,7 @@ protected:
     QList<cResource*> resourceList;
     QTcpServer* m_pSCPIServer;
     QTcpSocket* m_pSCPISocket;
+    cSCPIRouter* m_pSCPIRouter; // parametric commands not held in the scpi tree
 
 protected slots:
     virtual void doConfiguration() = 0; // all servers must configure
@@ -1,9 +1,10 @@
 #include "protonetcommand.h"
 
 
-cProtonetCommand::cProtonetCommand(XiQNetPeer *peer, bool hasClientId, bool withOutput, QByteArray clientid, quint32 messagenr, QString input)
-    :m_pPeer(peer), m_bhasClientId(hasClientId), m_bwithOutput(withOutput), m_clientId(clientid), m_nmessageNr(messagenr), m_sInput(input)
+cProtonetCommand::cProtonetCommand(XiQNetPeer *peer, bool hasClientId, bool withOutput, QByteArray clientid, quint32 messagenr, QString input, cAnswerHandler *answerHandler)
+    :m_pPeer(peer), m_bhasClientId(hasClientId), m_bwithOutput(withOutput), m_clientId(clientid), m_nmessageNr(messagenr), m_sInput(input), m_pAnswerHandler(answerHandler)
 {
+    m_Parsed.parse(&m_sInput);
 }
 
 
@@ -15,4 +16,13 @@ cProtonetCommand::cProtonetCommand(const cProtonetCommand *protoCmd)
     m_clientId = protoCmd->m_clientId;
     m_nmessageNr = protoCmd->m_nmessageNr;
     m_sInput = protoCmd->m_sInput;
+    m_Parsed.parse(&m_sInput); // our own view, the other one points to the other input
+    m_RouteParams = protoCmd->m_RouteParams;
+    m_pAnswerHandler = protoCmd->m_pAnswerHandler;
+}
+
+
+void cProtonetCommand::sendAnswer()
+{
+    m_pAnswerHandler->sendAnswer(this);
 }
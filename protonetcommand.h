@@ -3,21 +3,37 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
+
+#include "parsedcommand.h"
 
 class XiQNetPeer;
+class cProtonetCommand;
+
+class cAnswerHandler // the one who sends the answer of a finished command
+{
+public:
+    virtual ~cAnswerHandler() {}
+    virtual void sendAnswer(cProtonetCommand* protoCmd) = 0;
+};
+
 
 class cProtonetCommand
 {
 public:
-    cProtonetCommand(XiQNetPeer* peer, bool hasClientId, bool withOutput, QByteArray clientid, quint32 messagenr ,QString input);
+    cProtonetCommand(XiQNetPeer* peer, bool hasClientId, bool withOutput, QByteArray clientid, quint32 messagenr ,QString input, cAnswerHandler* answerHandler);
     cProtonetCommand(const cProtonetCommand* protoCmd);
+    void sendAnswer(); // the command is finished, 1 direct call however deep the executing object lives
     XiQNetPeer* m_pPeer;
     bool m_bhasClientId;
     bool m_bwithOutput;
     QByteArray m_clientId;
     quint32 m_nmessageNr;
     QString m_sInput;
+    cParsedCommand m_Parsed; // view into m_sInput, parse again if m_sInput changes
     QString m_sOutput;
+    QStringList m_RouteParams; // the parameter nodes of a routed command
+    cAnswerHandler* m_pAnswerHandler;
 };
 
 #endif // PROTONETCOMMAND_H
@@ -11,6 +11,13 @@
 #include "protonetcommand.h"
 
 
+static const cSCPIDelegateDescriptor SCHeadCommands[] =
+{
+    { "SCHEAD",         "VERSION", SCPI::isQuery, SCHeadSystem::cmdVersion },
+    { "SCHEAD:CHANNEL", "CATALOG", SCPI::isQuery, SCHeadSystem::cmdChannelCat },
+};
+
+
 cSCHeadInterface::cSCHeadInterface(cMT310S2dServer *server)
     :m_pMyServer(server)
 {
@@ -41,22 +48,15 @@ cSCHeadInterface::~cSCHeadInterface()
 
 void cSCHeadInterface::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1SCHEAD").arg(leadingNodes),"VERSION",SCPI::isQuery, m_pSCPIInterface, SCHeadSystem::cmdVersion);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SCHEAD:CHANNEL").arg(leadingNodes),"CATALOG", SCPI::isQuery, m_pSCPIInterface, SCHeadSystem::cmdChannelCat);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, SCHeadCommands);
+    findDelegate(SCHeadSystem::cmdVersion)->setStaticReply(m_sVersion);
 
     for (int i = 0; i < m_ChannelList.count(); i++)
     {
         connect(m_ChannelList.at(i), SIGNAL(notifier(cNotificationString*)), this, SIGNAL(notifier(cNotificationString*)));
-        connect(m_ChannelList.at(i), SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
         m_ChannelList.at(i)->initSCPIConnection(QString("%1SCHEAD").arg(leadingNodes));
     }
 }
@@ -97,7 +97,7 @@ void cSCHeadInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
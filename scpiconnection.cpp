@@ -35,6 +35,40 @@ void cSCPIConnection::removeSCPIConnections()
 }
 
 
+void cSCPIConnection::executeRoutedCommand(int cmdCode, cProtonetCommand *protoCmd)
+{
+    executeCommand(cmdCode, protoCmd);
+}
+
+
+void cSCPIConnection::addDelegates(const QString &prefix, const cSCPIDelegateDescriptor *table, int count)
+{
+    cSCPIDelegate* delegate;
+
+    m_DelegateList.reserve(m_DelegateList.count() + count);
+    for (int i = 0; i < count; i++)
+    {
+        QString cmdParent = prefix + QLatin1String(table[i].parent);
+        if (cmdParent.endsWith(':'))
+            cmdParent.chop(1);
+
+        delegate = new cSCPIDelegate(cmdParent, QLatin1String(table[i].name), table[i].type, m_pSCPIInterface, table[i].cmdCode);
+        delegate->setConnection(this);
+        m_DelegateList.append(delegate);
+    }
+}
+
+
+cSCPIDelegate *cSCPIConnection::findDelegate(quint16 cmdCode)
+{
+    for (int i = 0; i < m_DelegateList.count(); i++)
+        if (m_DelegateList.at(i)->getCmdCode() == cmdCode)
+            return m_DelegateList.at(i);
+
+    return 0;
+}
+
+
 void cSCPIConnection::executeCommand(int, QString&, QString&)
 {
 }
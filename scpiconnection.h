@@ -9,6 +9,15 @@ class cSCPI;
 class cNotificationString;
 
 
+struct cSCPIDelegateDescriptor // 1 entry of an interface's fixed command table
+{
+    const char* parent; // below the prefix given to addDelegates, "" for the prefix itself
+    const char* name;
+    quint8 type;
+    quint16 cmdCode;
+};
+
+
 class cSCPIConnection: public QObject // pure virtual base class for scpi model interfaces
 {
     Q_OBJECT
@@ -18,15 +27,23 @@ public:
     virtual ~cSCPIConnection();
     virtual void initSCPIConnection(QString leadingNodes) = 0;
     virtual void removeSCPIConnections();
+    void executeRoutedCommand(int cmdCode, cProtonetCommand* protoCmd); // entry for commands found by cSCPIRouter or table delegates
 
 signals:
     void notifier(cNotificationString* notifier);
-    void cmdExecutionDone(cProtonetCommand* protoCmd);
 
 protected:
     cSCPI* m_pSCPIInterface;
     QList<cSCPIDelegate*> m_DelegateList;
 
+    // generates the delegates of a command table, they call us directly so they need no connect
+    void addDelegates(const QString& prefix, const cSCPIDelegateDescriptor* table, int count);
+    template <int N> void addDelegates(const QString& prefix, const cSCPIDelegateDescriptor (&table)[N])
+    {
+        addDelegates(prefix, table, N);
+    }
+    cSCPIDelegate* findDelegate(quint16 cmdCode); // f.e. to give it a static reply
+
 
 protected slots:
     virtual void executeCommand(int, QString&, QString&);
@@ -4,13 +4,25 @@
 #include <QDebug>
 
 #include "scpidelegate.h"
+#include "protonetcommand.h"
+#include "scpiconnection.h"
+
+
+quint32 cSCPIDelegate::m_nModelGeneration = 0;
 
 
 cSCPIDelegate::cSCPIDelegate(QString cmdParent, QString cmd, quint8 type, cSCPI *scpiInterface, quint16 cmdCode)
-    :cSCPIObject(cmd, type), m_nCmdCode(cmdCode)
+    :cSCPIObject(cmd, type), m_nCmdCode(cmdCode), m_bStaticReply(false), m_pConnection(0)
 {
     m_sCommand = QString("%1:%2").arg(cmdParent).arg(cmd);
     scpiInterface->genSCPICmd(cmdParent.split(":"), this);
+    m_nModelGeneration++;
+}
+
+
+cSCPIDelegate::~cSCPIDelegate()
+{
+    m_nModelGeneration++; // our owner removed us from the command tree before
 }
 
 
@@ -23,7 +35,17 @@ bool cSCPIDelegate::executeSCPI(const QString &sInput, QString &sOutput)
 
 bool cSCPIDelegate::executeSCPI(cProtonetCommand *protoCmd)
 {
-    emit execute(m_nCmdCode, protoCmd);
+    if (m_bStaticReply && protoCmd->m_Parsed.isQuery())
+    {
+        protoCmd->m_sOutput = m_sStaticReply;
+        if (protoCmd->m_bwithOutput)
+            protoCmd->sendAnswer();
+    }
+    else if (m_pConnection)
+        m_pConnection->executeRoutedCommand(m_nCmdCode, protoCmd);
+    else
+        emit execute(m_nCmdCode, protoCmd);
+
     return true;
 }
 
@@ -34,3 +56,39 @@ QString cSCPIDelegate::getCommand()
 }
 
 
+quint16 cSCPIDelegate::getCmdCode()
+{
+    return m_nCmdCode;
+}
+
+
+void cSCPIDelegate::setStaticReply(const QString &reply)
+{
+    m_sStaticReply = reply;
+    m_bStaticReply = true;
+}
+
+
+void cSCPIDelegate::clearStaticReply()
+{
+    m_sStaticReply.clear();
+    m_bStaticReply = false;
+}
+
+
+void cSCPIDelegate::setConnection(cSCPIConnection *connection)
+{
+    m_pConnection = connection;
+}
+
+
+quint32 cSCPIDelegate::getModelGeneration()
+{
+    return m_nModelGeneration;
+}
+
+
+void cSCPIDelegate::modelChanged()
+{
+    m_nModelGeneration++;
+}
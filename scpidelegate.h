@@ -8,6 +8,7 @@
 
 class cSCPI;
 class cProtonetCommand;
+class cSCPIConnection;
 
 class cSCPIDelegate: public QObject, public cSCPIObject
 {
@@ -15,9 +16,16 @@ class cSCPIDelegate: public QObject, public cSCPIObject
 
 public:
     cSCPIDelegate(QString cmdParent, QString cmd, quint8 type, cSCPI *scpiInterface, quint16 cmdCode);
+    virtual ~cSCPIDelegate();
     virtual bool executeSCPI(const QString& sInput, QString& sOutput);
     virtual bool executeSCPI(cProtonetCommand* protoCmd);
     QString getCommand();
+    quint16 getCmdCode();
+    void setStaticReply(const QString& reply); // the answer to our query never changes, we give it without asking our owner
+    void clearStaticReply();
+    void setConnection(cSCPIConnection* connection); // we call our owner directly instead of emitting execute
+    static quint32 getModelGeneration(); // increases whenever a delegate is added or removed
+    static void modelChanged(); // for model parts that are no delegates, e.g. router routes
 
 signals:
     void execute(int cmdCode, QString& sInput, QString& sOutput);
@@ -26,6 +34,11 @@ signals:
 private:
     quint16 m_nCmdCode;
     QString m_sCommand;
+    QString m_sStaticReply;
+    bool m_bStaticReply;
+    cSCPIConnection* m_pConnection;
+
+    static quint32 m_nModelGeneration;
 };
 
 
@@ -0,0 +1,73 @@
+#include <QXmlStreamWriter>
+
+#include "scpirouter.h"
+#include "scpiconnection.h"
+#include "scpidelegate.h"
+#include "protonetcommand.h"
+
+
+cSCPIRouter::cSCPIRouter()
+{
+}
+
+
+void cSCPIRouter::addRoute(QString pattern, cSCPIConnection *handler, quint16 cmdCode)
+{
+    cRoute route;
+
+    route.m_Nodes = pattern.split(':', QString::SkipEmptyParts);
+    route.m_pHandler = handler;
+    route.m_nCmdCode = cmdCode;
+    m_RouteHash[route.m_Nodes.count()].append(route);
+    m_PatternList.append(route.m_Nodes.join(':'));
+    cSCPIDelegate::modelChanged(); // the exported interface now has 1 more route
+}
+
+
+bool cSCPIRouter::executeSCPI(cProtonetCommand *protoCmd)
+{
+    const cParsedCommand& cmd = protoCmd->m_Parsed;
+    int nodeCount = cmd.getNodeCount();
+
+    QHash<int, QList<cRoute> >::const_iterator it = m_RouteHash.constFind(nodeCount);
+    if (it == m_RouteHash.constEnd())
+        return false;
+
+    const QList<cRoute>& routes = it.value();
+    for (int i = 0; i < routes.count(); i++)
+    {
+        const cRoute& route = routes.at(i);
+        int j;
+
+        for (j = 0; j < nodeCount; j++)
+            if (route.m_Nodes.at(j) != "*" && route.m_Nodes.at(j).compare(cmd.getNode(j), Qt::CaseInsensitive) != 0)
+                break;
+
+        if (j == nodeCount)
+        {
+            protoCmd->m_RouteParams.clear();
+            for (j = 0; j < nodeCount; j++)
+                if (route.m_Nodes.at(j) == "*")
+                    protoCmd->m_RouteParams.append(cmd.getNode(j).toString());
+
+            route.m_pHandler->executeRoutedCommand(route.m_nCmdCode, protoCmd);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+QString cSCPIRouter::exportXML()
+{
+    QString sXML;
+    QXmlStreamWriter writer(&sXML);
+
+    writer.writeStartElement("ROUTES"); // * stands for any channel or range name
+    for (int i = 0; i < m_PatternList.count(); i++)
+        writer.writeTextElement("ROUTE", m_PatternList.at(i));
+    writer.writeEndElement();
+
+    return sXML;
+}
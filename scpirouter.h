@@ -0,0 +1,37 @@
+#ifndef SCPIROUTER_H
+#define SCPIROUTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+
+class cSCPIConnection;
+class cProtonetCommand;
+
+// parametric commands like SENSE:*:*:CORRECTION:GAIN are registered once for all channels
+// and ranges instead of 1 delegate per node. nodes matching * are passed to the handler
+// in the command's m_RouteParams. the cSCPI tree is always asked first, so routes only
+// see what it does not know
+
+class cSCPIRouter
+{
+public:
+    cSCPIRouter();
+    void addRoute(QString pattern, cSCPIConnection* handler, quint16 cmdCode);
+    bool executeSCPI(cProtonetCommand* protoCmd); // false if no route matches
+    QString exportXML(); // <ROUTES> with 1 <ROUTE> per pattern, for the interface export
+
+private:
+    struct cRoute
+    {
+        QStringList m_Nodes; // * for parameter nodes
+        cSCPIConnection* m_pHandler;
+        quint16 m_nCmdCode;
+    };
+
+    QHash<int, QList<cRoute> > m_RouteHash; // node count -> routes
+    QStringList m_PatternList; // all patterns in the order they were added
+};
+
+#endif // SCPIROUTER_H
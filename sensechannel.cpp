@@ -1,15 +1,19 @@
 #include <QList>
 #include <QString>
+#include <QByteArray>
+#include <QDataStream>
+#include <QTimer>
 
 #include <scpi.h>
-#include <scpicommand.h>
 #include "atmel.h"
+#include "justdata.h"
 #include "senserange.h"
 #include "scpiconnection.h"
 #include "sensesettings.h"
 #include "senseinterface.h"
 #include "sensechannel.h"
 #include "protonetcommand.h"
+#include "parsedcommand.h"
 
 extern cATMEL* pAtmel;
 
@@ -25,6 +29,11 @@ cSenseChannel::cSenseChannel(cSCPI* scpiinterface, QString description, QString
     m_nDspChannel = cSettings->m_nDspChannel;
     m_nOverloadBit = cSettings->m_nOverloadBit;
     m_bAvail = cSettings->avail;
+    m_nNotAdjusted = 0;
+    m_nCorrGeneration = 0;
+    m_bCorrNotificationPending = false;
+    m_pUnitDelegate = 0;
+    setNotifierCorrGeneration();
 }
 
 
@@ -43,15 +52,20 @@ void cSenseChannel::initSCPIConnection(QString leadingNodes)
         leadingNodes += ":";
 
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"ALIAS", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdAlias);
+    delegate->setStaticReply(m_sAlias);
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"TYPE", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdType);
+    delegate->setStaticReply(QString("0"));
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"UNIT", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdUnit);
+    delegate->setStaticReply(m_sUnit);
+    m_pUnitDelegate = delegate;
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"DSPCHANNEL", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdDspChannel);
+    delegate->setStaticReply(QString("%1").arg(m_nDspChannel));
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
     delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"STATUS", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdStatus);
@@ -69,10 +83,15 @@ void cSenseChannel::initSCPIConnection(QString leadingNodes)
     delegate = new cSCPIDelegate(QString("%1%2:RANGE").arg(leadingNodes).arg(m_sName),"CATALOG", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdRangeCat);
     m_DelegateList.append(delegate);
     connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    delegate = new cSCPIDelegate(QString("%1%2:CORRECTION").arg(leadingNodes).arg(m_sName),"ALL", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdCorrAll);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    delegate = new cSCPIDelegate(QString("%1%2:CORRECTION").arg(leadingNodes).arg(m_sName),"GENERATION", SCPI::isQuery, m_pSCPIInterface, SenseChannel::cmdCorrGeneration);
+    m_DelegateList.append(delegate);
+    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
 
     for (int i = 0;i < m_RangeList.count(); i++)
     {
-        connect(m_RangeList.at(i), SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
         m_RangeList.at(i)->initSCPIConnection(QString("%1%2").arg(leadingNodes).arg(m_sName));
     }
 }
@@ -84,43 +103,56 @@ void cSenseChannel::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     switch (cmdCode)
     {
     case SenseChannel::cmdAlias:
-        protoCmd->m_sOutput = m_ReadAlias(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadAlias(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdType:
-        protoCmd->m_sOutput = m_ReadType(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadType(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdUnit:
-        protoCmd->m_sOutput = m_ReadUnit(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadUnit(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdDspChannel:
-        protoCmd->m_sOutput = m_ReadDspChannel(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadDspChannel(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdStatus:
-        protoCmd->m_sOutput = m_ReadChannelStatus(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadChannelStatus(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdStatusReset:
-        protoCmd->m_sOutput = m_StatusReset(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_StatusReset(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdRange:
-        protoCmd->m_sOutput = m_ReadWriteRange(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadWriteRange(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdUrvalue:
-        protoCmd->m_sOutput = m_ReadUrvalue(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadUrvalue(protoCmd->m_Parsed);
         break;
     case SenseChannel::cmdRangeCat:
-        protoCmd->m_sOutput = m_ReadRangeCatalog(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeCatalog(protoCmd->m_Parsed);
+        break;
+    case SenseChannel::cmdCorrAll:
+        protoCmd->m_sOutput = m_ReadCorrections(protoCmd->m_Parsed);
+        break;
+    case SenseChannel::cmdCorrGeneration:
+        protoCmd->m_sOutput = m_ReadCorrGeneration(protoCmd->m_Parsed);
         break;
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 
 }
 
 
 void cSenseChannel::setRangeList(QList<cSenseRange*> &list)
 {
+    for (int i = 0; i < m_RangeList.count(); i++)
+        detachRange(m_RangeList.at(i));
+
     m_RangeList = list;
+    for (int i = 0; i < m_RangeList.count(); i++)
+        attachRange(m_RangeList.at(i));
+
+    buildRangeHash();
     setNotifierSenseChannelRangeCat();
     setNotifierSenseChannelRange();
 }
@@ -139,8 +171,10 @@ void cSenseChannel::addRangeList(QList<cSenseRange *> &list)
         cSenseRange *rng;
         rng = list.at(i);
         m_RangeList.append(rng);
+        attachRange(rng);
     }
 
+    buildRangeHash();
     setNotifierSenseChannelRangeCat();
 }
 
@@ -152,33 +186,113 @@ void cSenseChannel::removeRangeList(QList<cSenseRange *> &list)
         {
             cSenseRange *rng;
             rng = list.at(i);
-            m_RangeList.removeOne(rng);
+            if (m_RangeList.removeOne(rng))
+                detachRange(rng);
         }
 
+    buildRangeHash();
     setNotifierSenseChannelRangeCat();
 }
 
 
 cSenseRange *cSenseChannel::getRange(QString &name)
 {
-    int i;
-    for (i = 0; i < m_RangeList.count(); i++)
-        if (m_RangeList.at(i)->getName() == name)
-            break;
+    return m_RangeHash.value(name.toUpper(), 0);
+}
 
-    if (i < m_RangeList.count())
-        return m_RangeList.at(i);
-    else
-        return 0;
+
+void cSenseChannel::buildRangeHash()
+{
+    // ranges only come and go with clamps, so we simply build the hash again
+    m_RangeHash.clear();
+    for (int i = 0; i < m_RangeList.count(); i++)
+    {
+        QString key = m_RangeList.at(i)->getName().toUpper();
+        if (!m_RangeHash.contains(key)) // the first one wins like it did in the list
+            m_RangeHash[key] = m_RangeList.at(i);
+    }
 }
 
 
 quint8 cSenseChannel::getAdjustmentStatus()
 {
-    quint8 adj = 255;
-    for (int i = 0; i < m_RangeList.count(); i++ )
-        adj &= m_RangeList.at(i)->getAdjustmentStatus();
-    return adj;
+    // we only know whether all our ranges are justified or not
+    return (m_nNotAdjusted == 0) ? JustData::Justified : 0;
+}
+
+
+int cSenseChannel::getNotAdjustedCount()
+{
+    return m_nNotAdjusted;
+}
+
+
+void cSenseChannel::attachRange(cSenseRange *rng)
+{
+    int n = rng->getNotAdjustedCount();
+
+    connect(rng, SIGNAL(notAdjustedChanged(int)), this, SLOT(rangeAdjustmentChanged(int)));
+    connect(rng, SIGNAL(coefficientsChanged()), this, SLOT(rangeCorrectionChanged()));
+    if (n != 0)
+        rangeAdjustmentChanged(n);
+    rangeCorrectionChanged(); // our set of corrections has changed
+}
+
+
+void cSenseChannel::detachRange(cSenseRange *rng)
+{
+    int n = rng->getNotAdjustedCount();
+
+    disconnect(rng, SIGNAL(notAdjustedChanged(int)), this, SLOT(rangeAdjustmentChanged(int)));
+    disconnect(rng, SIGNAL(coefficientsChanged()), this, SLOT(rangeCorrectionChanged()));
+    if (n != 0)
+        rangeAdjustmentChanged(-n);
+    rangeCorrectionChanged();
+}
+
+
+void cSenseChannel::rangeAdjustmentChanged(int delta)
+{
+    m_nNotAdjusted += delta;
+    emit notAdjustedChanged(delta);
+}
+
+
+quint32 cSenseChannel::getCorrGeneration()
+{
+    return m_nCorrGeneration;
+}
+
+
+void cSenseChannel::SerializeCorrections(QDataStream &qds)
+{
+    qds << m_sName << m_nCorrGeneration << (quint16) m_RangeList.count();
+    for (int i = 0; i < m_RangeList.count(); i++)
+    {
+        qds << m_RangeList.at(i)->getName();
+        m_RangeList.at(i)->getJustData()->SerializeCoefficients(qds);
+    }
+}
+
+
+void cSenseChannel::rangeCorrectionChanged()
+{
+    // clamp ranges are cascaded with a range of the same channel, so we also cover their effective corrections
+    m_nCorrGeneration++;
+    emit correctionChanged();
+
+    if (!m_bCorrNotificationPending) // one notification per burst of changes
+    {
+        m_bCorrNotificationPending = true;
+        QTimer::singleShot(0, this, SLOT(setNotifierCorrGeneration()));
+    }
+}
+
+
+void cSenseChannel::setNotifierCorrGeneration()
+{
+    m_bCorrNotificationPending = false;
+    notifierCorrGeneration = QString("%1").arg(m_nCorrGeneration);
 }
 
 
@@ -215,6 +329,8 @@ void cSenseChannel::setDescription(const QString &s)
 void cSenseChannel::setUnit(QString &s)
 {
     m_sUnit = s;
+    if (m_pUnitDelegate)
+        m_pUnitDelegate->setStaticReply(m_sUnit);
 }
 
 
@@ -249,10 +365,8 @@ void cSenseChannel::computeJustData()
 }
 
 
-QString cSenseChannel::m_ReadAlias(QString &sInput)
+QString cSenseChannel::m_ReadAlias(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
         return getAlias();
@@ -262,10 +376,8 @@ QString cSenseChannel::m_ReadAlias(QString &sInput)
 }
 
 
-QString cSenseChannel::m_ReadType(QString &sInput)
+QString cSenseChannel::m_ReadType(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
         return QString("0");
     else
@@ -273,10 +385,8 @@ QString cSenseChannel::m_ReadType(QString &sInput)
 }
 
 
-QString cSenseChannel::m_ReadUnit(QString &sInput)
+QString cSenseChannel::m_ReadUnit(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
         return m_sUnit;
     else
@@ -284,10 +394,8 @@ QString cSenseChannel::m_ReadUnit(QString &sInput)
 }
 
 
-QString cSenseChannel::m_ReadDspChannel(QString &sInput)
+QString cSenseChannel::m_ReadDspChannel(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
         return QString("%1").arg(m_nDspChannel);
     else
@@ -295,14 +403,13 @@ QString cSenseChannel::m_ReadDspChannel(QString &sInput)
 }
 
 
-QString cSenseChannel::m_ReadChannelStatus(QString &sInput)
+QString cSenseChannel::m_ReadChannelStatus(const cParsedCommand &cmd)
 {
     quint16 status;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
-        if ( pAtmel->readCriticalStatus(status) == cmddone )
+        if ( pAtmel->readCriticalStatusShared(status) == cmddone )
         {
             quint32 r;
             r = ((m_bAvail) ? 0 : 1 << 31);
@@ -319,11 +426,9 @@ QString cSenseChannel::m_ReadChannelStatus(QString &sInput)
 }
 
 
-QString cSenseChannel::m_StatusReset(QString &sInput)
+QString cSenseChannel::m_StatusReset(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
-    if (cmd.isCommand(1) && (cmd.getParam(0) == ""))
+    if (cmd.isCommand(1) && cmd.getParam(0).isEmpty())
     {
         if (m_nOverloadBit >= 0)
         {
@@ -361,11 +466,9 @@ void cSenseChannel::setNotifierSenseChannelRange()
 }
 
 
-QString cSenseChannel::m_ReadWriteRange(QString &sInput)
+QString cSenseChannel::m_ReadWriteRange(const cParsedCommand &cmd)
 {
-    int i;
     quint8 mode;
-    cSCPICommand cmd = sInput;
 
     if ( pAtmel->readMeasMode(mode) == cmddone )
     {
@@ -379,15 +482,12 @@ QString cSenseChannel::m_ReadWriteRange(QString &sInput)
         {
             if (cmd.isCommand(1))
             {
-                QString rng = cmd.getParam(0);
-                int anz = m_RangeList.count();
-                for  (i = 0; i < anz; i++)
-                    if (m_RangeList.at(i)->getName() == rng)
-                        break;
-                if ( (i < anz) && (m_RangeList.at(i)->isAvail()) )
+                QString rng = cmd.getParam(0).toString();
+                cSenseRange* range = getRange(rng);
+                if ( (range != 0) && (range->isAvail()) )
                 {
                     // we know this range and it's available
-                    if ( pAtmel->setRange(m_nCtrlChannel, m_RangeList.at(i)->getSelCode()) == cmddone)
+                    if ( pAtmel->setRange(m_nCtrlChannel, range->getSelCode()) == cmddone)
                     {
                         notifierSenseChannelRange = rng;
                         return SCPI::scpiAnswer[SCPI::ack];
@@ -408,17 +508,16 @@ QString cSenseChannel::m_ReadWriteRange(QString &sInput)
 }
 
 
-QString cSenseChannel::m_ReadUrvalue(QString &sInput)
+QString cSenseChannel::m_ReadUrvalue(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
-        int i;
-        for (i = 0; i < m_RangeList.count(); i++)
-            if (m_RangeList.at(i)->getName() == notifierSenseChannelRange.getString())
-                break;
-        return QString("%1").arg(m_RangeList.at(i)->getUrvalue());
+        QString rngName = notifierSenseChannelRange.getString();
+        cSenseRange* range = getRange(rngName);
+        if (range != 0)
+            return QString("%1").arg(range->getUrvalue());
+        else
+            return SCPI::scpiAnswer[SCPI::errexec];
     }
 
     else
@@ -426,10 +525,8 @@ QString cSenseChannel::m_ReadUrvalue(QString &sInput)
 }
 
 
-QString cSenseChannel::m_ReadRangeCatalog(QString &sInput)
+QString cSenseChannel::m_ReadRangeCatalog(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
 
@@ -441,6 +538,37 @@ QString cSenseChannel::m_ReadRangeCatalog(QString &sInput)
 }
 
 
+QString cSenseChannel::m_ReadCorrections(const cParsedCommand &cmd)
+{
+    if (cmd.isQuery())
+    {
+        // version, then our name, generation and the effective coefficients of all ranges
+        QByteArray ba;
+        QDataStream stream(&ba, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_4);
+
+        stream << SenseChannel::CorrDumpVersion;
+        SerializeCorrections(stream);
+
+        return QString(ba.toBase64());
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cSenseChannel::m_ReadCorrGeneration(const cParsedCommand &cmd)
+{
+    if (cmd.isQuery())
+    {
+        emit notifier(&notifierCorrGeneration); // registers for notification, whose value follows delayed
+        return QString("%1").arg(m_nCorrGeneration); // the answer is always the live counter
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
 void cSenseChannel::setNotifierSenseChannelRangeCat()
 {
     int i;
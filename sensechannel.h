@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
 
 #include "senserange.h"
 #include "sensesettings.h"
@@ -20,14 +21,20 @@ enum Commands
     cmdStatusReset,
     cmdRange,
     cmdUrvalue,
-    cmdRangeCat
+    cmdRangeCat,
+    cmdCorrAll,
+    cmdCorrGeneration
 };
 
+const quint8 CorrDumpVersion = 1; // format version of the correction dump
+
 }
 
 
 class cSCPIConnection;
 class cSenseInterface;
+class QDataStream;
+class cParsedCommand;
 
 class cSenseChannel : public cSCPIConnection
 {
@@ -46,6 +53,9 @@ public:
     cSenseRange* getRange(QString& name);
 
     quint8 getAdjustmentStatus();
+    int getNotAdjustedCount(); // sum over all our ranges, clamp ranges included
+    quint32 getCorrGeneration(); // increases whenever one of our ranges' coefficients or the range list changes
+    void SerializeCorrections(QDataStream& qds); // name, generation and the effective coefficients of all ranges
 
     QString& getName();
     QString& getAlias();
@@ -59,34 +69,55 @@ public:
     void initJustData();
     void computeJustData();
 
+signals:
+    void notAdjustedChanged(int delta);
+    void correctionChanged();
+
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
+private slots:
+    void rangeAdjustmentChanged(int delta);
+    void rangeCorrectionChanged();
+    void setNotifierCorrGeneration();
+
 private:
     QString m_sName; // the channels name m0...
     QString m_sAlias; // the channel's alias name for example UL1
     QString m_sDescription; // the channel's brief description
     QString m_sUnit; // the channel's measured unit
+    cSCPIDelegate* m_pUnitDelegate; // answers our unit query from its static reply
     quint8 m_nCtrlChannel; // where to control the channel
     quint8 m_nDspChannel; // where to find the channel's sampled data
     qint8 m_nOverloadBit;
     bool m_bAvail; // is this channel available ?
     QList<cSenseRange*> m_RangeList;
+    QHash<QString, cSenseRange*> m_RangeHash; // upper case name -> range, follows m_RangeList
     quint8 m_nMMode;
-
-    QString m_ReadAlias(QString& sInput);
-    QString m_ReadType(QString& sInput);
-    QString m_ReadUnit(QString& sInput);
-    QString m_ReadDspChannel(QString& sInput);
-    QString m_ReadChannelStatus(QString& sInput);
-    QString m_StatusReset(QString& sInput);
-
-    QString m_ReadWriteRange(QString& sInput);
-    QString m_ReadUrvalue(QString& sInput);
-    QString m_ReadRangeCatalog(QString& sInput);
+    int m_nNotAdjusted;
+    quint32 m_nCorrGeneration;
+    bool m_bCorrNotificationPending;
+
+    void buildRangeHash();
+    void attachRange(cSenseRange* rng); // takes the range into our adjustment count
+    void detachRange(cSenseRange* rng);
+
+    QString m_ReadAlias(const cParsedCommand& cmd);
+    QString m_ReadType(const cParsedCommand& cmd);
+    QString m_ReadUnit(const cParsedCommand& cmd);
+    QString m_ReadDspChannel(const cParsedCommand& cmd);
+    QString m_ReadChannelStatus(const cParsedCommand& cmd);
+    QString m_StatusReset(const cParsedCommand& cmd);
+
+    QString m_ReadWriteRange(const cParsedCommand& cmd);
+    QString m_ReadUrvalue(const cParsedCommand& cmd);
+    QString m_ReadRangeCatalog(const cParsedCommand& cmd);
+    QString m_ReadCorrections(const cParsedCommand& cmd);
+    QString m_ReadCorrGeneration(const cParsedCommand& cmd);
 
     cNotificationString notifierSenseChannelRangeCat;
     cNotificationString notifierSenseChannelRange;
+    cNotificationString notifierCorrGeneration;
 
     void setNotifierSenseChannelRangeCat();
     void setNotifierSenseChannelRange();
@@ -1,11 +1,11 @@
 #include <QList>
 #include <QStringList>
-#include <QDomElement>
-#include <QDomDocument>
-#include <QDomText>
 #include <QDateTime>
-#include <QDebug>
+#include <QDataStream>
 #include <QFile>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QTimer>
 #include <syslog.h>
 #include "xmlsettings.h"
 #include "scpiconnection.h"
@@ -27,10 +27,134 @@
 #include "atmel.h"
 #include "adjflash.h"
 #include "protonetcommand.h"
+#include "scpirouter.h"
 
 
 extern cATMEL* pAtmel;
 
+// the voltage channels m0, m1, m2, m6
+static constexpr SenseRange::cRangeDescriptor VoltageRanges[] =
+{
+    // name      alias    avail  urvalue   rejection  ovrejection adcrejection sel mmask
+    { "250V",   "250V",   true,   250.0,  4415057.0,  5518821.0,  8388607.0,  0, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "8V",     "8V",     true,     8.0,  3355443.0,  4194304.0,  8388607.0,  1, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "100mV",  "100mV",  true,     0.1,  4026532.0,  5033165.0,  8388607.0,  2, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+};
+
+// the current channels m3, m4, m5, the secondary ranges are used by clamps
+static constexpr SenseRange::cRangeDescriptor CurrentRanges[] =
+{
+    // name      alias    avail  urvalue   rejection  ovrejection adcrejection sel mmask
+    { "10A",    "10A",    true,    10.0,  3197613.0,  3997016.0,  8388607.0,  0, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "5A",     "5A",     true,     5.0,  3197613.0,  3997016.0,  8388607.0,  1, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "2.5A",   "2.5A",   true,     2.5,  3997016.0,  4996270.0,  8388607.0,  2, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "1.0A",   "1.0A",   true,     1.0,  4177527.0,  5221909.0,  8388607.0,  3, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "500mA",  "500mA",  true,     0.5,  4177527.0,  5221909.0,  8388607.0,  4, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "250mA",  "250mA",  true,    0.25,  4177527.0,  5221909.0,  8388607.0,  5, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "100mA",  "100mA",  true,     0.1,  4177527.0,  5221909.0,  8388607.0,  6, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "50mA",   "50mA",   true,    0.05,  4177527.0,  5221909.0,  8388607.0,  7, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "25mA",   "25mA",   true,   0.025,  4177527.0,  5221909.0,  8388607.0,  8, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "8V",     "8V",     false,    8.0,  3355443.0,  4194304.0,  8388607.0,  9, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "5V",     "5V",     false,    5.0,  4194304.0,  5242880.0,  8388607.0, 10, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "2V",     "2V",     false,    2.0,  2835586.0,  3544483.0,  8388607.0, 11, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "1V",     "1V",     false,    1.0,  2835586.0,  3544483.0,  8388607.0, 12, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "500mV",  "500mV",  false,    0.5,  3544482.0,  4430603.0,  8388607.0, 13, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "200mV",  "200mV",  false,    0.2,  2684355.0,  3355444.0,  8388607.0, 14, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "100mV",  "100mV",  false,    0.1,  3355443.0,  4194304.0,  8388607.0, 15, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "50mV",   "50mV",   false,   0.05,  3355443.0,  4194304.0,  8388607.0, 16, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "20mV",   "20mV",   false,   0.02,  2684355.0,  3355444.0,  8388607.0, 17, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "10mV",   "10mV",   false,   0.01,  3355443.0,  4194304.0,  8388607.0, 18, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "5mV",    "5mV",    false,  0.005,  3355443.0,  4194304.0,  8388607.0, 19, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "2mV",    "2mV",    false,  0.002,  2684355.0,  3355444.0,  8388607.0, 20, SenseSystem::modeADJ | SenseSystem::Direct },
+};
+
+// m7 has no primary ranges of its own
+static constexpr SenseRange::cRangeDescriptor AuxRanges[] =
+{
+    // name      alias    avail  urvalue   rejection  ovrejection adcrejection sel mmask
+    { "0A",     "--",     true,     0.0,  3197613.0,  3997016.0,  8388607.0,  0, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct },
+    { "8V",     "8V",     false,    8.0,  3355443.0,  4194304.0,  8388607.0,  9, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "5V",     "5V",     false,    5.0,  4194304.0,  5242880.0,  8388607.0, 10, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "2V",     "2V",     false,    2.0,  2835586.0,  3544483.0,  8388607.0, 11, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "1V",     "1V",     false,    1.0,  2835586.0,  3544483.0,  8388607.0, 12, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "500mV",  "500mV",  false,    0.5,  3544482.0,  4430603.0,  8388607.0, 13, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "200mV",  "200mV",  false,    0.2,  2684355.0,  3355444.0,  8388607.0, 14, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "100mV",  "100mV",  false,    0.1,  3355443.0,  4194304.0,  8388607.0, 15, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "50mV",   "50mV",   false,   0.05,  3355443.0,  4194304.0,  8388607.0, 16, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "20mV",   "20mV",   false,   0.02,  2684355.0,  3355444.0,  8388607.0, 17, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "10mV",   "10mV",   false,   0.01,  3355443.0,  4194304.0,  8388607.0, 18, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "5mV",    "5mV",    false,  0.005,  3355443.0,  4194304.0,  8388607.0, 19, SenseSystem::modeADJ | SenseSystem::Direct },
+    { "2mV",    "2mV",    false,  0.002,  2684355.0,  3355444.0,  8388607.0, 20, SenseSystem::modeADJ | SenseSystem::Direct },
+};
+
+// the commands below SENSE:<channel>:<range>
+struct cSenseRoute
+{
+    const char* nodes;
+    quint16 cmdCode;
+};
+
+static const cSenseRoute RangeRoutes[] =
+{
+    { "TYPE",                        SenseSystem::routeRange | SenseRange::cmdType },
+    { "ALIAS",                       SenseSystem::routeRange | SenseRange::cmdAlias },
+    { "AVAIL",                       SenseSystem::routeRange | SenseRange::cmdAvail },
+    { "URVALUE",                     SenseSystem::routeRange | SenseRange::cmdValue },
+    { "REJECTION",                   SenseSystem::routeRange | SenseRange::cmdRejection },
+    { "OVREJECTION",                 SenseSystem::routeRange | SenseRange::cmdOVRejection },
+    { "ADCREJECTION",                SenseSystem::routeRange | SenseRange::cmdADWRejection },
+    { "CORRECTION:GAIN",             SenseSystem::routeJustData | DirectGain },
+    { "CORRECTION:ADJGAIN",          SenseSystem::routeJustData | DirectJustGain },
+    { "CORRECTION:PHASE",            SenseSystem::routeJustData | DirectPhase },
+    { "CORRECTION:ADJPHASE",         SenseSystem::routeJustData | DirectJustPhase },
+    { "CORRECTION:OFFSET",           SenseSystem::routeJustData | DirectOffset },
+    { "CORRECTION:ADJOFFSET",        SenseSystem::routeJustData | DirectJustOffset },
+    { "CORRECTION:STATUS",           SenseSystem::routeJustData | DirectJustStatus },
+    { "CORRECTION:COMPUTE",          SenseSystem::routeJustData | DirectJustCompute },
+    { "CORRECTION:INIT",             SenseSystem::routeJustData | DirectJustInit },
+    { "CORRECTION:TABLE",            SenseSystem::routeJustData | DirectJustTable },
+    { "CORRECTION:TABLE:RESOLUTION", SenseSystem::routeJustData | DirectJustTableResolution }
+};
+
+// the commands below SENSE:<channel>:<range>:CORRECTION:<GAIN|PHASE|OFFSET>
+static const cSenseRoute CorrectionRoutes[] =
+{
+    { "STATUS",                JustStatus },
+    { "COEFFICIENT:0",         JustCoefficient0 },
+    { "COEFFICIENT:1",         JustCoefficient1 },
+    { "COEFFICIENT:2",         JustCoefficient2 },
+    { "COEFFICIENT:3",         JustCoefficient3 },
+    { "NODE:0",                JustNode0 },
+    { "NODE:1",                JustNode1 },
+    { "NODE:2",                JustNode2 },
+    { "NODE:3",                JustNode3 },
+    { "ACCUMULATOR:SAMPLE",    JustAccuSample },
+    { "ACCUMULATOR:STATISTIC", JustAccuStatistic },
+    { "ACCUMULATOR:COMMIT",    JustAccuCommit },
+    { "ACCUMULATOR:RESET",     JustAccuReset }
+};
+
+
+static const cSCPIDelegateDescriptor SenseCommands[] =
+{
+    { "SENSE",            "VERSION",    SCPI::isQuery,                 SenseSystem::cmdVersion },
+    { "SENSE",            "MMODE",      SCPI::isQuery | SCPI::isCmdwP, SenseSystem::cmdMMode },
+    { "SENSE:MMODE",      "CATALOG",    SCPI::isQuery,                 SenseSystem::cmdMModeCat },
+    { "SENSE:CHANNEL",    "CATALOG",    SCPI::isQuery,                 SenseSystem::cmdChannelCat },
+    { "SENSE:GROUP",      "CATALOG",    SCPI::isQuery,                 SenseSystem::cmdGroupCat },
+    { "SENSE:CORRECTION", "INIT",       SCPI::isCmd,                   SenseSystem::initAdjData },
+    { "SENSE:CORRECTION", "COMPUTE",    SCPI::isCmd,                   SenseSystem::computeAdjData },
+    { "SENSE:CORRECTION", "ALL",        SCPI::isQuery,                 SenseSystem::cmdCorrAll },
+    { "SENSE:CORRECTION", "GENERATION", SCPI::isQuery,                 SenseSystem::cmdCorrGeneration },
+};
+
+
+static const cSCPIDelegateDescriptor SenseStatusCommands[] =
+{
+    { "STATUS:PCB", "ADJUSTMENT", SCPI::isQuery, SenseSystem::cmdStatAdjustment },
+};
+
+
 cSenseInterface::cSenseInterface(cMT310S2dServer *server)
     :cAdjFlash(server->m_pI2CSettings->getDeviceNode(), server->m_pDebugSettings->getDebugLevel(), server->m_pI2CSettings->getI2CAdress(i2cSettings::flash)), cAdjXML(server->m_pDebugSettings->getDebugLevel()), m_pMyServer(server)
 {
@@ -65,81 +189,39 @@ cSenseInterface::cSenseInterface(cMT310S2dServer *server)
     pChannel = new cSenseChannel(m_pSCPIInterface, SenseSystem::sCurrentChannelDescription,"A", channelSettings.at(7), 7);
     m_ChannelList.append(pChannel);
 
-    QList<cSenseRange*> rngList;
-
     for (i = 0; i < 4; i++)
-    {
-        rngList.clear();
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "250V",   "250V", true, 250.0, 4415057.0, 5518821.0, 8388607.0, 0, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,    "8V",     "8V", true,   8.0, 3355443.0, 4194304.0, 8388607.0, 1, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "100mV" , "100mV", true,   0.1, 4026532.0, 5033165.0, 8388607.0, 2, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-
-        /*
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "HF250V",   "250V", false, 250.0, 1078.0, 1294.0, 0, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,   "HF10V",    "10V", false,   8.0,  819.0,  983.0, 1, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF100mV" , "100mV", false,   0.1,  983.0, 1126.0, 2, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        */
-
-        m_ChannelList.at(i)->setRangeList(rngList);
-    }
+        m_ChannelList.at(i)->setRangeList(createRangeList(VoltageRanges, sizeof(VoltageRanges) / sizeof(VoltageRanges[0])));
 
     for (i = 4; i < 7; i++)
+        m_ChannelList.at(i)->setRangeList(createRangeList(CurrentRanges, sizeof(CurrentRanges) / sizeof(CurrentRanges[0])));
+
+    m_ChannelList.at(7)->setRangeList(createRangeList(AuxRanges, sizeof(AuxRanges) / sizeof(AuxRanges[0])));
+
+    // all ranges we have so far are direct ranges which hold adjustment data in our flash
+    for (i = 0; i < m_ChannelList.count(); i++)
     {
-        rngList.clear();
-        rngList.append(new cSenseRange(m_pSCPIInterface,   "10A",   "10A", true,  10.0, 3197613.0, 3997016.0, 8388607.0,  0, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,    "5A",    "5A", true,   5.0, 3197613.0, 3997016.0, 8388607.0,  1, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "2.5A",  "2.5A", true,   2.5, 3997016.0, 4996270.0, 8388607.0,  2, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "1.0A",  "1.0A", true,   1.0, 4177527.0, 5221909.0, 8388607.0,  3, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "500mA", "500mA", true,   0.5, 4177527.0, 5221909.0, 8388607.0,  4, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "250mA", "250mA", true,  0.25, 4177527.0, 5221909.0, 8388607.0,  5, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "100mA", "100mA", true,   0.1, 4177527.0, 5221909.0, 8388607.0,  6, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "50mA",  "50mA", true,  0.05, 4177527.0, 5221909.0, 8388607.0,  7, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "25mA",  "25mA", true, 0.025, 4177527.0, 5221909.0, 8388607.0,  8, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-
-        rngList.append(new cSenseRange(m_pSCPIInterface,    "8V",    "8V", false,   8.0, 3355443.0, 4194304.0, 8388607.0,  9, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,    "5V",    "5V", false,   5.0, 4194304.0, 5242880.0, 8388607.0, 10, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,    "2V",    "2V", false,   2.0, 2835586.0, 3544483.0, 8388607.0, 11, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,    "1V",    "1V", false,   1.0, 2835586.0, 3544483.0, 8388607.0, 12, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "500mV", "500mV", false,   0.5, 3544482.0, 4430603.0, 8388607.0, 13, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "200mV", "200mV", false,   0.2, 2684355.0, 3355444.0, 8388607.0, 14, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "100mV", "100mV", false,   0.1, 3355443.0, 4194304.0, 8388607.0, 15, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "50mV",  "50mV", false,  0.05, 3355443.0, 4194304.0, 8388607.0, 16, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "20mV",  "20mV", false,  0.02, 2684355.0, 3355444.0, 8388607.0, 17, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,  "10mV",  "10mV", false,  0.01, 3355443.0, 4194304.0, 8388607.0, 18, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,   "5mV",   "5mV", false, 0.005, 3355443.0, 4194304.0, 8388607.0, 19, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface,   "2mV",   "2mV", false, 0.002, 2684355.0, 3355444.0, 8388607.0, 20, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-
-        /*
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF10A"  ,"10A"  , false, 10.0  , 781.0,  938.0, 0, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF5A"    ,"5A"  , false,  5.0  , 781.0,  938.0, 0, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF2.5A" ,"2.5A" , false,  2.5  , 976.0, 1172.0, 2, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF1.0A" ,"1.0A" , false,  1.0  ,1020.0, 1224.0, 3, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF500mA","500mA", false,  0.5  ,1020.0, 1224.0, 4, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF250mA","250mA", false,  0.25 ,1020.0, 1224.0, 5, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF100mA","100mA", false,  0.1  ,1020.0, 1224.0, 6, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF50mA" ,"50mA" , false,  0.05 ,1020.0, 1224.0, 7, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        rngList.append(new cSenseRange(m_pSCPIInterface, "HF25mA" ,"25mA" , false,  0.025,1020.0, 1224.0, 8, SenseSystem::modeHF | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-        */
-
-        m_ChannelList.at(i)->setRangeList(rngList);
+        cSenseChannel* chn = m_ChannelList.at(i);
+        m_ChannelHash[chn->getName().toUpper()] = chn;
+        m_CtrlChannelHash[chn->getCtrlChannel()] = chn;
+        QList<cSenseRange*>& list = chn->getRangeList();
+        for (int j = 0; j < list.count(); j++)
+            m_AdjRecordHash[adjRecordId(chn, list.at(j))] = list.at(j);
     }
 
-    rngList.clear();
-    rngList.append(new cSenseRange(m_pSCPIInterface,    "0A",    "--", true,    0.0, 3197613.0, 3997016.0, 8388607.0,  0, SenseSystem::modeAC | SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,    "8V",    "8V", false,   8.0, 3355443.0, 4194304.0, 8388607.0,  9, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,    "5V",    "5V", false,   5.0, 4194304.0, 5242880.0, 8388607.0, 10, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,    "2V",    "2V", false,   2.0, 2835586.0, 3544483.0, 8388607.0, 11, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,    "1V",    "1V", false,   1.0, 2835586.0, 3544483.0, 8388607.0, 12, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface, "500mV", "500mV", false,   0.5, 3544482.0, 4430603.0, 8388607.0, 13, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface, "200mV", "200mV", false,   0.2, 2684355.0, 3355444.0, 8388607.0, 14, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface, "100mV", "100mV", false,   0.1, 3355443.0, 4194304.0, 8388607.0, 15, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,  "50mV",  "50mV", false,  0.05, 3355443.0, 4194304.0, 8388607.0, 16, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,  "20mV",  "20mV", false,  0.02, 2684355.0, 3355444.0, 8388607.0, 17, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,  "10mV",  "10mV", false,  0.01, 3355443.0, 4194304.0, 8388607.0, 18, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,   "5mV",   "5mV", false, 0.005, 3355443.0, 4194304.0, 8388607.0, 19, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-    rngList.append(new cSenseRange(m_pSCPIInterface,   "2mV",   "2mV", false, 0.002, 2684355.0, 3355444.0, 8388607.0, 20, SenseSystem::modeADJ | SenseSystem::Direct, new cMT310S2JustData(m_pSCPIInterface)));
-
-    m_ChannelList.at(7)->setRangeList(rngList);
+    // the adjustment status is counted up and down by our channels from now on
+    m_nVersionStatus = 0;
+    m_nSerialStatus = 0;
+    m_nNotAdjusted = 0;
+    m_nCorrGeneration = 0;
+    m_bCorrNotificationPending = false;
+    for (i = 0; i < m_ChannelList.count(); i++)
+    {
+        m_nNotAdjusted += m_ChannelList.at(i)->getNotAdjustedCount();
+        connect(m_ChannelList.at(i), SIGNAL(notAdjustedChanged(int)), this, SLOT(channelAdjustmentChanged(int)));
+        connect(m_ChannelList.at(i), SIGNAL(correctionChanged()), this, SLOT(channelCorrectionChanged()));
+    }
+    setNotifierSenseAdjStatus();
+    setNotifierCorrGeneration();
 
     setSenseMode("AC");
 
@@ -163,77 +245,51 @@ cSenseInterface::~cSenseInterface()
 
 void cSenseInterface::initSCPIConnection(QString leadingNodes)
 {
-    QString cmdParent;
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1SENSE").arg(leadingNodes),"VERSION",SCPI::isQuery, m_pSCPIInterface, SenseSystem::cmdVersion);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SENSE").arg(leadingNodes),"MMODE",SCPI::isQuery | SCPI::isCmdwP , m_pSCPIInterface, SenseSystem::cmdMMode);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SENSE:MMODE").arg(leadingNodes),"CATALOG",SCPI::isQuery, m_pSCPIInterface, SenseSystem::cmdMModeCat );
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SENSE:CHANNEL").arg(leadingNodes),"CATALOG", SCPI::isQuery, m_pSCPIInterface, SenseSystem::cmdChannelCat);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SENSE:GROUP").arg(leadingNodes),"CATALOG", SCPI::isQuery, m_pSCPIInterface, SenseSystem::cmdGroupCat);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SENSE:CORRECTION").arg(leadingNodes),"INIT", SCPI::isCmd, m_pSCPIInterface, SenseSystem::initAdjData);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SENSE:CORRECTION").arg(leadingNodes),"COMPUTE", SCPI::isCmd, m_pSCPIInterface, SenseSystem::computeAdjData);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, SenseCommands);
+    findDelegate(SenseSystem::cmdVersion)->setStaticReply(m_sVersion);
 
 
     for (int i = 0; i < m_ChannelList.count(); i++)
     {
-        // we also must connect the signals for notification and for output
+        // we also must connect the signals for notification
         connect(m_ChannelList.at(i), SIGNAL(notifier(cNotificationString*)), this, SIGNAL(notifier(cNotificationString*)));
-        connect(m_ChannelList.at(i), SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
 
         m_ChannelList.at(i)->initSCPIConnection(QString("%1SENSE").arg(leadingNodes));
     }
 
-    cmdParent = QString("STATUS:PCB");
+    cSCPIRouter* router = m_pMyServer->getSCPIRouter();
+    QString rangeNodes = QString("%1SENSE:*:*").arg(leadingNodes);
 
-    delegate = new cSCPIDelegate(cmdParent, "ADJUSTMENT", SCPI::isQuery, m_pSCPIInterface, SenseSystem::cmdStatAdjustment);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    for (uint i = 0; i < sizeof(RangeRoutes) / sizeof(RangeRoutes[0]); i++)
+        router->addRoute(QString("%1:%2").arg(rangeNodes).arg(RangeRoutes[i].nodes), this, RangeRoutes[i].cmdCode);
 
+    for (uint i = 0; i < sizeof(CorrectionRoutes) / sizeof(CorrectionRoutes[0]); i++)
+    {
+        router->addRoute(QString("%1:CORRECTION:GAIN:%2").arg(rangeNodes).arg(CorrectionRoutes[i].nodes), this, SenseSystem::routeGainCorrection | CorrectionRoutes[i].cmdCode);
+        router->addRoute(QString("%1:CORRECTION:PHASE:%2").arg(rangeNodes).arg(CorrectionRoutes[i].nodes), this, SenseSystem::routePhaseCorrection | CorrectionRoutes[i].cmdCode);
+        router->addRoute(QString("%1:CORRECTION:OFFSET:%2").arg(rangeNodes).arg(CorrectionRoutes[i].nodes), this, SenseSystem::routeOffsetCorrection | CorrectionRoutes[i].cmdCode);
+    }
+
+    addDelegates(QString(), SenseStatusCommands); // no leading nodes here
 }
 
 
 cSenseChannel *cSenseInterface::getChannel(QString &name)
 {
-    int i;
-
-    for (i = 0; i < m_ChannelList.count(); i++)
-        if (m_ChannelList.at(i)->getName() == name)
-            break;
-
-    if (i < m_ChannelList.count())
-        return m_ChannelList.at(i);
-    else
-        return 0;
+    return m_ChannelHash.value(name.toUpper(), 0);
 }
 
 
 QString cSenseInterface::getChannelSystemName(quint16 ctrlChannel)
 {
     QString s;
-    for (int i = 0; i < m_ChannelList.count(); i++)
-        if (m_ChannelList.at(i)->getCtrlChannel() == ctrlChannel)
-        {
-            s = m_ChannelList.at(i)->getName();
-            break;
-        }
+    cSenseChannel* chn = m_CtrlChannelHash.value(ctrlChannel, 0);
+
+    if (chn != 0)
+        s = chn->getName();
 
     return s;
 }
@@ -241,18 +297,21 @@ QString cSenseInterface::getChannelSystemName(quint16 ctrlChannel)
 
 cSenseRange* cSenseInterface::getRange(QString channelName, QString rangeName)
 {
-    return getChannel(channelName)->getRange(rangeName);
+    cSenseChannel* chn = getChannel(channelName);
+
+    if (chn != 0)
+        return chn->getRange(rangeName);
+    else
+        return 0;
 }
 
 
 quint8 cSenseInterface::getAdjustmentStatus()
 {
-    quint8 stat = 255;
+    quint8 stat;
     quint8 stat2;
-    for (int i = 0; i < m_ChannelList.count(); i++)
-        stat &= m_ChannelList.at(i)->getAdjustmentStatus();
 
-    if ((stat & JustData::Justified)== 0)
+    if (m_nNotAdjusted != 0)
         stat = Adjustment::notAdjusted;
     else
         stat = Adjustment::adjusted;
@@ -270,12 +329,18 @@ quint8 cSenseInterface::getAdjustmentStatus()
 
 void cSenseInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
 {
+    if ((cmdCode & SenseSystem::routeMask) > 0)
+    {
+        routeCommand(cmdCode, protoCmd);
+        return;
+    }
+
     switch (cmdCode)
     {
     case SenseSystem::cmdVersion:
         protoCmd->m_sOutput = m_ReadVersion(protoCmd->m_sInput);
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
         break;
     case SenseSystem::cmdMMode:
         m_ReadWriteMMode(protoCmd);
@@ -284,32 +349,42 @@ void cSenseInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     case SenseSystem::cmdMModeCat:
         protoCmd->m_sOutput = m_ReadMModeCatalog(protoCmd->m_sInput);
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
         break;
     case SenseSystem::cmdChannelCat:
         protoCmd->m_sOutput = m_ReadSenseChannelCatalog(protoCmd->m_sInput);
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
         break;
     case SenseSystem::cmdGroupCat:
         protoCmd->m_sOutput = m_ReadSenseGroupCatalog(protoCmd->m_sInput);
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
         break;
     case SenseSystem::initAdjData:
         protoCmd->m_sOutput = m_InitSenseAdjData(protoCmd->m_sInput);
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
         break;
     case SenseSystem::computeAdjData:
         protoCmd->m_sOutput = m_ComputeSenseAdjData(protoCmd->m_sInput);
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
         break;
     case SenseSystem::cmdStatAdjustment:
         protoCmd->m_sOutput = m_ReadAdjStatus(protoCmd->m_sInput);
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
+        break;
+    case SenseSystem::cmdCorrAll:
+        protoCmd->m_sOutput = m_ReadCorrections(protoCmd->m_sInput);
+        if (protoCmd->m_bwithOutput)
+            protoCmd->sendAnswer();
+        break;
+    case SenseSystem::cmdCorrGeneration:
+        protoCmd->m_sOutput = m_ReadCorrGeneration(protoCmd->m_sInput);
+        if (protoCmd->m_bwithOutput)
+            protoCmd->sendAnswer();
         break;
 
     }
@@ -317,13 +392,66 @@ void cSenseInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
 
 
 bool cSenseInterface::importAdjData(QDataStream &stream)
+{
+    quint32 magic;
+    quint16 format, nRecords;
+    quint32 dirOffset;
+
+    stream.skipRawData(6); // we don't need count and chksum
+    stream >> magic;
+    if (magic != SenseSystem::AdjImageMagic)
+    {
+        // an image written by an older server, we read it once and write the new format next time
+        stream.device()->seek(0);
+        return importLegacyAdjData(stream);
+    }
+
+    stream >> format >> nRecords >> dirOffset;
+    if (format > SenseSystem::AdjImageFormat)
+    {
+        if DEBUG1 syslog(LOG_ERR,"flashmemory read, unknown image format\n");
+        return false;
+    }
+
+    bool headerOK = importAdjHeader(stream);
+    setNotifierSenseAdjStatus(); // serial and version status may have changed
+    if (!headerOK)
+        return false;
+
+    QList<quint16> idList;
+    QList<quint32> offsetList;
+
+    stream.device()->seek(dirOffset);
+    for (int i = 0; i < nRecords; i++)
+    {
+        quint16 id;
+        quint32 offset;
+        stream >> id >> offset;
+        idList.append(id);
+        offsetList.append(offset);
+    }
+
+    for (int i = 0; i < nRecords; i++)
+    {
+        // records we don't know are simply not read
+        if (m_AdjRecordHash.contains(idList.at(i)))
+        {
+            stream.device()->seek(offsetList.at(i));
+            m_AdjRecordHash[idList.at(i)]->getJustData()->Deserialize(stream);
+        }
+    }
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+
+bool cSenseInterface::importAdjHeader(QDataStream &stream)
 {
     QDateTime DateTime;
     QString SVersion;
     char flashdata[200];
     char* s = flashdata;
 
-    stream.skipRawData(6); // we don't need count and chksum
     stream >> s;
     if (QString(s) != "ServerVersion")
     {
@@ -393,6 +521,21 @@ bool cSenseInterface::importAdjData(QDataStream &stream)
     stream >> s;
     DateTime.fromString(QString(s),Qt::TextDate); // datum und uhrzeit übernehmen
 
+    return true;
+}
+
+
+bool cSenseInterface::importLegacyAdjData(QDataStream &stream)
+{
+    char flashdata[200];
+    char* s = flashdata;
+
+    stream.skipRawData(6); // we don't need count and chksum
+    bool headerOK = importAdjHeader(stream);
+    setNotifierSenseAdjStatus(); // serial and version status may have changed
+    if (!headerOK)
+        return false;
+
     while (!stream.atEnd())
     {
         bool done;
@@ -429,13 +572,34 @@ bool cSenseInterface::importAdjData(QDataStream &stream)
     }
 
     return (true);
-
 }
 
 
 void cSenseInterface::exportAdjData(QDataStream &stream)
 {
     QDateTime DateTime;
+    QList<cSenseRange*> rangeList;
+    QList<quint16> idList;
+
+    for (int i = 0; i < m_ChannelList.count(); i++)
+    {
+        QList<cSenseRange*> list = m_ChannelList.at(i)->getRangeList();
+        for (int j = 0; j < list.count(); j ++)
+        {
+            if ((list.at(j)->getMMask() & SenseSystem::Direct)> 0)
+            {
+                rangeList.append(list.at(j));
+                idList.append(adjRecordId(m_ChannelList.at(i), list.at(j)));
+            }
+        }
+    }
+
+    // fixed header, the directory offset gets patched when we know it
+    qint64 headerPos = stream.device()->pos();
+    stream << SenseSystem::AdjImageMagic;
+    stream << SenseSystem::AdjImageFormat;
+    stream << (quint16) rangeList.count();
+    stream << (quint32) 0;
 
     // ab version v1.02
     stream << "ServerVersion";
@@ -446,85 +610,63 @@ void cSenseInterface::exportAdjData(QDataStream &stream)
     stream << m_pMyServer->m_pSystemInfo->getSerialNumber().toStdString().c_str(); // seriennummer
     stream << DateTime.currentDateTime().toString(Qt::TextDate).toStdString().c_str(); // datum,uhrzeit
 
-    for (int i = 0; i < m_ChannelList.count(); i++)
+    quint32 dirOffset = stream.device()->pos();
+    for (int i = 0; i < rangeList.count(); i++) // place holders for the directory
+        stream << idList.at(i) << (quint32) 0;
+
+    QList<quint32> offsetList;
+    QHash<QByteArray, quint32> recordHash; // identical records are written once and shared in the directory
+    for (int i = 0; i < rangeList.count(); i++)
     {
-        QList<cSenseRange*> list = m_ChannelList.at(i)->getRangeList();
-        QString spec;
+        QByteArray rec;
+        QDataStream recStream(&rec, QIODevice::WriteOnly);
+        recStream.setVersion(QDataStream::Qt_5_4);
+        rangeList.at(i)->getJustData()->Serialize(recStream);
 
-        for (int j = 0; j < list.count(); j ++)
+        if (!recordHash.contains(rec))
         {
-            if ((list.at(j)->getMMask() & SenseSystem::Direct)> 0)
-            {
-                spec = QString("%1:%2:%3")
-                     .arg("SENSE")
-                     .arg(m_ChannelList.at(i)->getName())
-                     .arg(list.at(j)->getName());
-
-                stream << spec.toLatin1();
-                list.at(j)->getJustData()->Serialize(stream);
-            }
+            recordHash[rec] = stream.device()->pos();
+            stream.writeRawData(rec.constData(), rec.size());
         }
+        offsetList.append(recordHash[rec]);
     }
-}
-
 
-QString cSenseInterface::exportXMLString(int indent)
-{
-    QDateTime DateTime;
+    qint64 endPos = stream.device()->pos();
 
-    QString s = QString("PCBAdjustmentData");
-    QDomDocument justqdom (s);
+    stream.device()->seek(headerPos + 8);
+    stream << dirOffset;
+    stream.device()->seek(dirOffset);
+    for (int i = 0; i < rangeList.count(); i++)
+        stream << idList.at(i) << offsetList.at(i);
 
-    QDomElement pcbtag = justqdom.createElement( "PCB" );
-    justqdom.appendChild( pcbtag );
+    stream.device()->seek(endPos);
+}
 
-    QDomElement tag = justqdom.createElement( "Type" );
-    pcbtag.appendChild( tag );
-    QDomText t = justqdom.createTextNode(LeiterkartenName);
-    tag.appendChild( t );
 
-    tag = justqdom.createElement( "VersionNumber" );
-    pcbtag.appendChild( tag );
-    t = justqdom.createTextNode(m_pMyServer->m_pSystemInfo->getDeviceVersion() );
-    tag.appendChild( t );
+void cSenseInterface::exportXML(QXmlStreamWriter &writer)
+{
+    QDateTime DateTime;
 
-    tag = justqdom.createElement( "SerialNumber" );
-    pcbtag.appendChild( tag );
-    t = justqdom.createTextNode(m_pMyServer->m_pSystemInfo->getSerialNumber());
-    tag.appendChild( t );
+    writer.writeDTD("<!DOCTYPE PCBAdjustmentData>");
+    writer.writeStartElement("PCB");
 
-    tag = justqdom.createElement( "Date" );
-    pcbtag.appendChild( tag );
+    writeXMLText(writer, "Type", LeiterkartenName);
+    writeXMLText(writer, "VersionNumber", m_pMyServer->m_pSystemInfo->getDeviceVersion());
+    writeXMLText(writer, "SerialNumber", m_pMyServer->m_pSystemInfo->getSerialNumber());
     QDate d=DateTime.currentDateTime().date();
-    t = justqdom.createTextNode(d.toString(Qt::TextDate));
-    tag.appendChild( t );
-
-    tag = justqdom.createElement( "Time" );
-    pcbtag.appendChild( tag );
+    writeXMLText(writer, "Date", d.toString(Qt::TextDate));
     QTime ti=DateTime.currentDateTime().time();
-    t = justqdom.createTextNode(ti.toString(Qt::TextDate));
-    tag.appendChild( t );
-
-    QDomElement adjtag = justqdom.createElement( "Adjustment" );
-    pcbtag.appendChild( adjtag );
+    writeXMLText(writer, "Time", ti.toString(Qt::TextDate));
 
-    QDomElement chksumtag = justqdom.createElement("Chksum");
-    adjtag.appendChild(chksumtag);
-    t = justqdom.createTextNode(QString("0x%1").arg(m_nChecksum,0,16));
-    chksumtag.appendChild(t);
+    writer.writeStartElement("Adjustment");
+    writeXMLText(writer, "Chksum", QString("0x%1").arg(m_nChecksum,0,16));
 
-    QDomElement typeTag = justqdom.createElement( "Sense");
-    adjtag.appendChild(typeTag);
+    writer.writeStartElement("Sense");
 
     for (int i = 0; i < m_ChannelList.count(); i ++)
     {
-        QDomText t;
-        QDomElement chtag = justqdom.createElement( "Channel" );
-        typeTag.appendChild( chtag );
-        QDomElement nametag = justqdom.createElement( "Name" );
-        chtag.appendChild(nametag);
-        t = justqdom.createTextNode(m_ChannelList.at(i)->getName());
-        nametag.appendChild( t );
+        writer.writeStartElement("Channel");
+        writeXMLText(writer, "Name", m_ChannelList.at(i)->getName());
 
         QList<cSenseRange*> list = m_ChannelList.at(i)->getRangeList();
         for (int j = 0; j < list.count(); j++)
@@ -533,73 +675,21 @@ QString cSenseInterface::exportXMLString(int indent)
             {
                 cSenseRange* rng = list.at(j);
 
-                QDomElement rtag = justqdom.createElement( "Range" );
-                chtag.appendChild( rtag );
-
-                nametag = justqdom.createElement( "Name" );
-                rtag.appendChild(nametag);
-
-                t = justqdom.createTextNode(list.at(j)->getName());
-                nametag.appendChild( t );
-
-                QDomElement gpotag = justqdom.createElement( "Gain" );
-                rtag.appendChild(gpotag);
-                QDomElement tag = justqdom.createElement( "Status" );
-                QString jdata = rng->getJustData()->m_pGainCorrection->SerializeStatus();
-                t = justqdom.createTextNode(jdata);
-                gpotag.appendChild(tag);
-                tag.appendChild(t);
-                tag = justqdom.createElement( "Coefficients" );
-                gpotag.appendChild(tag);
-                jdata = rng->getJustData()->m_pGainCorrection->SerializeCoefficients();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
-                tag = justqdom.createElement( "Nodes" );
-                gpotag.appendChild(tag);
-                jdata = rng->getJustData()->m_pGainCorrection->SerializeNodes();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
-
-                gpotag = justqdom.createElement( "Phase" );
-                rtag.appendChild(gpotag);
-                tag = justqdom.createElement( "Status" );
-                jdata = rng->getJustData()->m_pPhaseCorrection->SerializeStatus();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
-                gpotag.appendChild(tag);
-                tag = justqdom.createElement( "Coefficients" );
-                gpotag.appendChild(tag);
-                jdata = rng->getJustData()->m_pPhaseCorrection->SerializeCoefficients();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
-                tag = justqdom.createElement( "Nodes" );
-                gpotag.appendChild(tag);
-                jdata = rng->getJustData()->m_pPhaseCorrection->SerializeNodes();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
-
-                gpotag = justqdom.createElement( "Offset" );
-                rtag.appendChild(gpotag);
-                tag = justqdom.createElement( "Status" );
-                jdata = rng->getJustData()->m_pOffsetCorrection->SerializeStatus();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
-                gpotag.appendChild(tag);
-                tag = justqdom.createElement( "Coefficients" );
-                gpotag.appendChild(tag);
-                jdata = rng->getJustData()->m_pOffsetCorrection->SerializeCoefficients();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
-                tag = justqdom.createElement( "Nodes" );
-                gpotag.appendChild(tag);
-                jdata = rng->getJustData()->m_pOffsetCorrection->SerializeNodes();
-                t = justqdom.createTextNode(jdata);
-                tag.appendChild(t);
+                writer.writeStartElement("Range");
+                writeXMLText(writer, "Name", rng->getName());
+                writeXMLCorrection(writer, "Gain", rng->getJustData()->m_pGainCorrection);
+                writeXMLCorrection(writer, "Phase", rng->getJustData()->m_pPhaseCorrection);
+                writeXMLCorrection(writer, "Offset", rng->getJustData()->m_pOffsetCorrection);
+                writer.writeEndElement(); // Range
             }
         }
+
+        writer.writeEndElement(); // Channel
     }
 
-    return justqdom.toString(indent);
+    writer.writeEndElement(); // Sense
+    writer.writeEndElement(); // Adjustment
+    writer.writeEndElement(); // PCB
 }
 
 
@@ -610,19 +700,12 @@ void cSenseInterface::m_ComputeSenseAdjData()
 }
 
 
-bool cSenseInterface::importXMLDocument(QDomDocument* qdomdoc) // n steht auf einem element dessen tagname channel ist
+bool cSenseInterface::importXML(QXmlStreamReader &reader)
 {
-    QDateTime DateTime;
-    QDomDocumentType TheDocType = qdomdoc->doctype ();
+    QList<cAdjXMLCorrection> stage;
 
-    if  (TheDocType.name() != QString("PCBAdjustmentData"))
-    {
-        if DEBUG1 syslog(LOG_ERR,"justdata import, wrong xml documentype\n");
+    if (!readXMLDocType(reader, "PCBAdjustmentData"))
         return false;
-    }
-
-    QDomElement rootElem = qdomdoc->documentElement();
-    QDomNodeList nl = rootElem.childNodes();
 
     bool TypeOK = false;
     bool VersionNrOK = false;
@@ -632,21 +715,13 @@ bool cSenseInterface::importXMLDocument(QDomDocument* qdomdoc) // n steht auf ei
     bool ChksumOK = false;
     bool SenseOK = false;
 
-    for (int i = 0; i < nl.length() ; i++)
+    while (reader.readNextStartElement())
     {
-        QDomNode qdNode = nl.item(i);
-        QDomElement qdElem = qdNode.toElement();
-        if ( qdElem.isNull() )
-        {
-            if DEBUG1 syslog(LOG_ERR,"justdata import, format error in xml file\n");
-            return false;
-        }
-
-        QString tName = qdElem.tagName();
+        QString tName = reader.name().toString();
 
         if (tName == "Type")
         {
-            if ( !(TypeOK = (qdElem.text() == QString(LeiterkartenName))))
+            if ( !(TypeOK = (reader.readElementText() == QString(LeiterkartenName))))
             {
                 if DEBUG1 syslog(LOG_ERR,"justdata import, wrong type information in xml file\n");
                 return false;
@@ -657,7 +732,7 @@ bool cSenseInterface::importXMLDocument(QDomDocument* qdomdoc) // n steht auf ei
 
         if (tName == "SerialNumber")
         {
-            if (  !(SerialNrOK = (qdElem.text() == m_pMyServer->m_pSystemInfo->getSerialNumber() )) )
+            if (  !(SerialNrOK = (reader.readElementText() == m_pMyServer->m_pSystemInfo->getSerialNumber() )) )
             {
                if DEBUG1 syslog(LOG_ERR,"justdata import, wrong serialnumber in xml file\n");
                return false;
@@ -669,7 +744,7 @@ bool cSenseInterface::importXMLDocument(QDomDocument* qdomdoc) // n steht auf ei
 
         if (tName == "VersionNumber")
         {
-           if ( ! ( VersionNrOK= (qdElem.text() == m_pMyServer->m_pSystemInfo->getDeviceVersion()) ) )
+           if ( ! ( VersionNrOK= (reader.readElementText() == m_pMyServer->m_pSystemInfo->getDeviceVersion()) ) )
            {
                if DEBUG1 syslog(LOG_ERR,"justdata import, wrong versionnumber in xml file\n");
                return false;
@@ -681,18 +756,15 @@ bool cSenseInterface::importXMLDocument(QDomDocument* qdomdoc) // n steht auf ei
 
         if (tName=="Date")
         {
-            QDate d = QDate::fromString(qdElem.text(),Qt::TextDate);
-            DateTime.setDate(d);
+            reader.skipCurrentElement();
             DateOK = true;
-
         }
 
         else
 
         if (tName=="Time")
         {
-            QTime t = QTime::fromString(qdElem.text(),Qt::TextDate);
-            DateTime.setTime(t);
+            reader.skipCurrentElement();
             TimeOK = true;
         }
 
@@ -700,120 +772,67 @@ bool cSenseInterface::importXMLDocument(QDomDocument* qdomdoc) // n steht auf ei
 
         if (tName == "Adjustment")
         {
-            if ( VersionNrOK && SerialNrOK && DateOK && TimeOK && TypeOK)
+            if ( !(VersionNrOK && SerialNrOK && DateOK && TimeOK && TypeOK) )
             {
-                QDomNodeList adjChildNl = qdElem.childNodes();
-                for (qint32 j = 0; j < adjChildNl.length(); j++)
-                {
-                    QString tagName;
+                if DEBUG1 syslog(LOG_ERR,"justdata import, xml file contains strange data\n");
+                return false;
+            }
 
-                    qdNode = adjChildNl.item(j);
+            while (reader.readNextStartElement())
+            {
+                if (reader.name() == "Chksum")
+                {
+                    ChksumOK = true; // we don't read it actually because if something was changed outside ....
+                    reader.skipCurrentElement();
+                }
 
-                    tagName = qdNode.toElement().tagName();
-                    if (tagName == "Chksum")
-                    {
-                        ChksumOK = true; // we don't read it actually because if something was changed outside ....
-                    }
+                else
 
-                    else
+                if (reader.name() == "Sense")
+                {
+                    SenseOK = true;
 
-                    if (qdNode.toElement().tagName() == "Sense")
+                    while (reader.readNextStartElement()) // we iterate over all channels from xml file
                     {
-                        SenseOK = true;
+                        if (reader.name() != "Channel")
+                        {
+                            reader.skipCurrentElement();
+                            continue;
+                        }
 
-                        QDomNodeList channelNl = qdNode.childNodes(); // we have a list our channels entries now
+                        QString chnName;
 
-                        for (qint32 i = 0; i < channelNl.length(); i++)
+                        while (reader.readNextStartElement())
                         {
-                            QDomNode chnNode = channelNl.item(i); // we iterate over all channels from xml file
-
-                            QDomNodeList chnEntryNl = chnNode.childNodes();
-                            for (qint32 j = 0; j < chnEntryNl.length(); j++)
-                            {
-                                cSenseChannel* chnPtr;
-                                cSenseRange* rngPtr;
-                                QString Name;
+                            if (reader.name() == "Name")
+                                chnName = reader.readElementText();
 
-                                QDomNode ChannelJustNode = chnEntryNl.item(j);
-                                qdElem = ChannelJustNode.toElement();
-                                QString tName = qdElem.tagName();
-                                qDebug() << tName;
+                            else
 
-                                if (tName == "Name")
-                                {
-                                    Name = qdElem.text();
-                                    qDebug() << Name;
-                                    chnPtr = getChannel(Name);
-                                }
+                            if (reader.name() == "Range")
+                            {
+                                QString rngName;
+                                QList<cAdjXMLCorrection> corrList;
 
-                                if (tName == "Range")
+                                if (readXMLRange(reader, rngName, corrList))
                                 {
-                                    if (chnPtr != 0) // if we know this channel
-                                    {
-                                        QDomNodeList chnJustNl = ChannelJustNode.childNodes();
-
-                                        for (qint32 k = 0; k < chnJustNl.length(); k++)
-                                        {
-                                            QDomNode RangeJustNode = chnJustNl.item(k);
-
-                                            qdElem = RangeJustNode.toElement();
-                                            tName = qdElem.tagName();
-                                            qDebug() << tName;
-
-                                            if (tName == "Name")
-                                            {
-                                                Name = qdElem.text();
-                                                qDebug() << Name;
-                                                rngPtr = chnPtr->getRange(Name);
-                                            }
-
-                                            cJustData* pJustData = 0;
-
-                                            if (rngPtr != 0)
-                                            {
-                                                if (tName == "Gain")
-                                                    pJustData = rngPtr->getJustData()->m_pGainCorrection;
-
-                                                if (tName == "Phase")
-                                                    pJustData = rngPtr->getJustData()->m_pPhaseCorrection;
-
-                                                if (tName == "Offset")
-                                                    pJustData = rngPtr->getJustData()->m_pOffsetCorrection;
-                                            }
-
-                                            if (pJustData)
-                                            {
-                                                QDomNodeList jdataNl = RangeJustNode.childNodes();
-                                                for (qint32 k = 0; k < jdataNl.count(); k++)
-                                                {
-                                                    QDomNode jTypeNode = jdataNl.item(k);
-                                                    QString jTypeName = jTypeNode.toElement().tagName();
-                                                    QString jdata = jTypeNode.toElement().text();
-
-                                                    if (jTypeName == "Status")
-                                                        pJustData->DeserializeStatus(jdata);
-
-                                                    if (jTypeName == "Coefficients")
-                                                        pJustData->DeserializeCoefficients(jdata);
-
-                                                    if (jTypeName == "Nodes")
-                                                        pJustData->DeserializeNodes(jdata);
-                                                }
-                                            }
-                                        }
-                                    }
+                                    cSenseRange* rngPtr = getRange(chnName, rngName);
+                                    if (rngPtr != 0) // if we know this range
+                                        stageXMLRange(rngPtr->getJustData(), corrList, stage);
                                 }
                             }
+
+                            else
+                                reader.skipCurrentElement();
                         }
                     }
                 }
-            }
-            else
-            {
-                if DEBUG1 syslog(LOG_ERR,"justdata import, xml file contains strange data\n");
-                return false;
+
+                else
+                    reader.skipCurrentElement();
             }
         }
+
         else
         {
             if DEBUG1 syslog(LOG_ERR,"justdata import, xml file contains strange data\n");
@@ -821,7 +840,79 @@ bool cSenseInterface::importXMLDocument(QDomDocument* qdomdoc) // n steht auf ei
         }
     }
 
-    return ChksumOK && SenseOK;
+    if (reader.hasError())
+    {
+        if DEBUG1 syslog(LOG_ERR,"justdata import, format error in xml file\n");
+        return false;
+    }
+
+    if (!(ChksumOK && SenseOK))
+        return false;
+
+    commitXMLCorrections(stage); // the document was ok, now we take over its data
+    return true;
+}
+
+
+quint16 cSenseInterface::adjRecordId(cSenseChannel *chn, cSenseRange *rng)
+{
+    quint16 chnNr = chn->getName().mid(1).toUInt(); // m0 .. m7
+    return (chnNr << 8) | rng->getSelCode();
+}
+
+
+void cSenseInterface::routeCommand(int cmdCode, cProtonetCommand *protoCmd)
+{
+    cSCPIConnection* target = 0;
+    // like scpi nodes, channel and range names are not case sensitive, the hashes are upper case
+    cSenseChannel* chn = getChannel(protoCmd->m_RouteParams[0]);
+
+    if (chn)
+    {
+        cSenseRange* rng = chn->getRange(protoCmd->m_RouteParams[1]); // clamp ranges included
+
+        if (rng)
+        {
+            switch (cmdCode & SenseSystem::routeMask)
+            {
+            case SenseSystem::routeRange:
+                target = rng;
+                break;
+            case SenseSystem::routeJustData:
+                target = rng->getJustData();
+                break;
+            case SenseSystem::routeGainCorrection:
+                target = rng->getJustData()->m_pGainCorrection;
+                break;
+            case SenseSystem::routePhaseCorrection:
+                target = rng->getJustData()->m_pPhaseCorrection;
+                break;
+            case SenseSystem::routeOffsetCorrection:
+                target = rng->getJustData()->m_pOffsetCorrection;
+                break;
+            }
+        }
+    }
+
+    if (target)
+        target->executeRoutedCommand(cmdCode & ~SenseSystem::routeMask, protoCmd); // the target answers
+    else
+    {
+        protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
+        if (protoCmd->m_bwithOutput)
+            protoCmd->sendAnswer();
+    }
+}
+
+
+QList<cSenseRange*> cSenseInterface::createRangeList(const SenseRange::cRangeDescriptor *descriptors, int count)
+{
+    QList<cSenseRange*> rngList;
+
+    for (int i = 0; i < count; i++)
+        rngList.append(new cSenseRange(m_pSCPIInterface, &descriptors[i], new cMT310S2JustData(m_pSCPIInterface)));
+
+    return rngList;
 }
 
 
@@ -831,6 +922,16 @@ void cSenseInterface::setI2CMux()
 }
 
 
+QString cSenseInterface::getCacheKey()
+{
+    cSystemInfo* pInfo = m_pMyServer->m_pSystemInfo;
+
+    if (!pInfo->dataRead())
+        return QString(); // without serial number we don't use a cache
+    return QString("%1-%2").arg(LeiterkartenName).arg(pInfo->getSerialNumber());
+}
+
+
 void cSenseInterface::registerResource(cRMConnection *rmConnection, quint16 port)
 {
     cSenseChannel* pChannel;
@@ -886,7 +987,7 @@ void cSenseInterface::m_ReadWriteMMode(cProtonetCommand *protoCmd)
         emit notifier(&notifierSenseMMode);
         protoCmd->m_sOutput  = notifierSenseMMode.getString();
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
     }
     else
     {
@@ -904,7 +1005,7 @@ void cSenseInterface::m_ReadWriteMMode(cProtonetCommand *protoCmd)
             protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
 
         if (protoCmd->m_bwithOutput)
-            emit cmdExecutionDone(protoCmd);
+            protoCmd->sendAnswer();
 
     }
 }
@@ -999,10 +1100,44 @@ QString cSenseInterface::m_ReadAdjStatus(QString &sInput)
 
     if (cmd.isQuery())
     {
-        QString s;
+        emit notifier(&notifierSenseAdjStatus);
+        return notifierSenseAdjStatus.getString();
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
 
-        s = QString("%1").arg(getAdjustmentStatus());
-        return s;
+
+QString cSenseInterface::m_ReadCorrections(QString &sInput)
+{
+    cSCPICommand cmd = sInput;
+
+    if (cmd.isQuery())
+    {
+        // version, generation and then all channels with the effective coefficients of their ranges
+        QByteArray ba;
+        QDataStream stream(&ba, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_4);
+
+        stream << SenseChannel::CorrDumpVersion << m_nCorrGeneration << (quint16) m_ChannelList.count();
+        for (int i = 0; i < m_ChannelList.count(); i++)
+            m_ChannelList.at(i)->SerializeCorrections(stream);
+
+        return QString(ba.toBase64());
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cSenseInterface::m_ReadCorrGeneration(QString &sInput)
+{
+    cSCPICommand cmd = sInput;
+
+    if (cmd.isQuery())
+    {
+        emit notifier(&notifierCorrGeneration); // registers for notification, whose value follows delayed
+        return QString("%1").arg(m_nCorrGeneration); // the answer is always the live counter
     }
     else
         return SCPI::scpiAnswer[SCPI::nak];
@@ -1027,6 +1162,46 @@ void cSenseInterface::setNotifierSenseChannelCat()
 }
 
 
+void cSenseInterface::setNotifierSenseAdjStatus()
+{
+    QString s = QString("%1").arg(getAdjustmentStatus());
+
+    if (s != notifierSenseAdjStatus.getString())
+    {
+        notifierSenseAdjStatus = s;
+        emit adjustmentStatusChanged();
+    }
+}
+
+
+void cSenseInterface::channelAdjustmentChanged(int delta)
+{
+    m_nNotAdjusted += delta;
+    setNotifierSenseAdjStatus();
+}
+
+
+void cSenseInterface::channelCorrectionChanged()
+{
+    m_nCorrGeneration++;
+
+    // compute, import or a clamp change all touch many coefficients at once,
+    // so we notify our clients once after the whole burst is done
+    if (!m_bCorrNotificationPending)
+    {
+        m_bCorrNotificationPending = true;
+        QTimer::singleShot(0, this, SLOT(setNotifierCorrGeneration()));
+    }
+}
+
+
+void cSenseInterface::setNotifierCorrGeneration()
+{
+    m_bCorrNotificationPending = false;
+    notifierCorrGeneration = QString("%1").arg(m_nCorrGeneration);
+}
+
+
 bool cSenseInterface::setSenseMode(QString sMode)
 {
     bool ret;
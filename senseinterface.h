@@ -18,7 +18,12 @@
 namespace SenseSystem
 {
 
-const QString Version = "V1.00";
+const QString Version = "V1.01";
+
+// binary adjustment image, from V1.01 on we write a record directory behind a fixed header
+// so records can be found by numeric channel/range id without parsing the whole image
+const quint32 AdjImageMagic = 0x41444A32; // "ADJ2"
+const quint16 AdjImageFormat = 1;
 
 enum Commands
 {
@@ -29,7 +34,22 @@ enum Commands
     cmdGroupCat,
     initAdjData,
     computeAdjData,
-    cmdStatAdjustment
+    cmdStatAdjustment,
+    cmdCorrAll,
+    cmdCorrGeneration
+};
+
+
+// range and adjustment data commands are routed for all channels and ranges by 1 pattern,
+// the route tells us which object of the addressed range gets the command
+enum Routes
+{
+    routeRange = 0x100,
+    routeJustData = 0x200,
+    routeGainCorrection = 0x300,
+    routePhaseCorrection = 0x400,
+    routeOffsetCorrection = 0x500,
+    routeMask = 0xff00
 };
 
 
@@ -74,29 +94,50 @@ public:
     virtual quint8 getAdjustmentStatus(); // we return 0 if adj. otherwise  1 +2 +4
     virtual void registerResource(cRMConnection *rmConnection, quint16 port);
     virtual void unregisterResource(cRMConnection *rmConnection);
-    virtual QString exportXMLString(int indent = 1);
     void m_ComputeSenseAdjData();
 
+signals:
+    void adjustmentStatusChanged(); // our status as returned by getAdjustmentStatus has changed
+
 protected:
     virtual void exportAdjData(QDataStream& stream);
     virtual bool importAdjData(QDataStream& stream);
-    virtual bool importXMLDocument(QDomDocument* qdomdoc);
+    virtual void exportXML(QXmlStreamWriter& writer);
+    virtual bool importXML(QXmlStreamReader& reader);
+    bool importAdjHeader(QDataStream& stream); // checks the image's identification strings
+    bool importLegacyAdjData(QDataStream& stream);
 
     virtual void setI2CMux();
+    virtual QString getCacheKey();
 
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
+private slots:
+    void channelAdjustmentChanged(int delta);
+    void channelCorrectionChanged();
+    void setNotifierCorrGeneration();
+
 private:
     cMT310S2dServer* m_pMyServer;
 
     QList<cSenseChannel*> m_ChannelList;
+    QHash<QString, cSenseChannel*> m_ChannelHash; // upper case name -> channel
+    QHash<quint16, cSenseChannel*> m_CtrlChannelHash; // ctrl channel -> channel
+    QHash<quint16, cSenseRange*> m_AdjRecordHash; // adjustment record id -> range
+
+    quint16 adjRecordId(cSenseChannel* chn, cSenseRange* rng); // channel number << 8 | range selection code
+    QList<cSenseRange*> createRangeList(const SenseRange::cRangeDescriptor* descriptors, int count);
+    void routeCommand(int cmdCode, cProtonetCommand* protoCmd); // SENSE:<channel>:<range>:...
     QString m_sVersion;
     QString m_sMMode;
     QHash<QString,quint8> m_MModeHash;
 
     quint8 m_nVersionStatus;
     qint8 m_nSerialStatus;
+    int m_nNotAdjusted; // sum over all channels, so the status query needs no loops
+    quint32 m_nCorrGeneration; // increases whenever any channel's corrections change
+    bool m_bCorrNotificationPending;
 
     QString m_ReadVersion(QString& sInput);
     void m_ReadWriteMMode(cProtonetCommand* protoCmd);
@@ -106,12 +147,17 @@ private:
     QString m_InitSenseAdjData(QString& sInput);
     QString m_ComputeSenseAdjData(QString& sInput);
     QString m_ReadAdjStatus(QString& sInput);
+    QString m_ReadCorrections(QString& sInput);
+    QString m_ReadCorrGeneration(QString& sInput);
 
     cNotificationString notifierSenseMMode;
     cNotificationString notifierSenseChannelCat;
+    cNotificationString notifierSenseAdjStatus;
+    cNotificationString notifierCorrGeneration;
 
     void setNotifierSenseMMode();
     void setNotifierSenseChannelCat();
+    void setNotifierSenseAdjStatus();
 
     bool setSenseMode(QString sMode);
 };
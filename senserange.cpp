@@ -1,16 +1,19 @@
 #include <scpi.h>
-#include <scpicommand.h>
 
 #include "senserange.h"
 #include "mt310s2justdata.h"
-#include "scpidelegate.h"
 #include "protonetcommand.h"
+#include "parsedcommand.h"
 
 
-cSenseRange::cSenseRange(cSCPI *scpiinterface, QString name, QString alias, bool avail, double rValue, double rejection, double ovrejection, double adcrejection, quint8 rselcode, quint16 mmask, cMT310S2JustData* justdata)
-    :m_sName(name), m_sAlias(alias), m_bAvail(avail), m_fRValue(rValue), m_fRejection(rejection), m_fOVRejection(ovrejection), m_fADCRejection(adcrejection), m_nSelCode(rselcode), m_nMMask(mmask), m_pJustdata(justdata)
+cSenseRange::cSenseRange(cSCPI *scpiinterface, const SenseRange::cRangeDescriptor* descriptor, cMT310S2JustData* justdata)
+    :m_pDescriptor(descriptor), m_sName(QString::fromLatin1(descriptor->name)), m_sAlias(QString::fromLatin1(descriptor->alias)), m_bAvail(descriptor->avail), m_pJustdata(justdata)
 {
     m_pSCPIInterface = scpiinterface;
+    // gain and offset tables cover the range up to its overload value
+    m_pJustdata->setTableArgMax(m_pDescriptor->rValue * m_pDescriptor->ovrejection / m_pDescriptor->rejection);
+    connect(m_pJustdata, SIGNAL(notAdjustedChanged(int)), this, SIGNAL(notAdjustedChanged(int)));
+    connect(m_pJustdata, SIGNAL(coefficientsChanged()), this, SIGNAL(coefficientsChanged()));
 }
 
 
@@ -22,35 +25,8 @@ cSenseRange::~cSenseRange()
 
 void cSenseRange::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
-    if (leadingNodes != "")
-        leadingNodes += ":";
-
-    delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"TYPE",SCPI::isQuery, m_pSCPIInterface, SenseRange::cmdType);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"ALIAS",SCPI::isQuery, m_pSCPIInterface, SenseRange::cmdAlias);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"AVAIL",SCPI::isQuery, m_pSCPIInterface, SenseRange::cmdAvail);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"URVALUE",SCPI::isQuery, m_pSCPIInterface, SenseRange::cmdValue);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"REJECTION",SCPI::isQuery, m_pSCPIInterface, SenseRange::cmdRejection);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"OVREJECTION",SCPI::isQuery, m_pSCPIInterface, SenseRange::cmdOVRejection);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1%2").arg(leadingNodes).arg(m_sName),"ADCREJECTION",SCPI::isQuery, m_pSCPIInterface, SenseRange::cmdADWRejection);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-
-    connect(m_pJustdata, SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
-    m_pJustdata->initSCPIConnection(QString("%1%2").arg(leadingNodes).arg(m_sName));
+    // our commands and those of our adjustment data are routed to us by the sense interface
+    m_pJustdata->initSCPIConnection(QString("%1%2").arg(leadingNodes).arg(getName()));
 }
 
 
@@ -60,7 +36,13 @@ quint8 cSenseRange::getAdjustmentStatus()
 }
 
 
-QString &cSenseRange::getName()
+int cSenseRange::getNotAdjustedCount()
+{
+    return m_pJustdata->getNotAdjustedCount();
+}
+
+
+QString cSenseRange::getName()
 {
     return m_sName;
 }
@@ -68,19 +50,19 @@ QString &cSenseRange::getName()
 
 double cSenseRange::getUrvalue()
 {
-    return m_fRValue;
+    return m_pDescriptor->rValue;
 }
 
 
 quint8 cSenseRange::getSelCode()
 {
-    return m_nSelCode;
+    return m_pDescriptor->selCode;
 }
 
 
 quint16 cSenseRange::getMMask()
 {
-    return m_nMMask;
+    return m_pDescriptor->mmask;
 }
 
 
@@ -99,7 +81,7 @@ bool cSenseRange::isAvail()
 void cSenseRange::setMMode(int m)
 {
     m_nMMode = m;
-    m_bAvail = ((m_nMMask & m_nMMode) > 0);
+    m_bAvail = ((m_pDescriptor->mmask & m_nMMode) > 0);
 }
 
 
@@ -120,49 +102,45 @@ void cSenseRange::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     switch (cmdCode)
     {
     case SenseRange::cmdType:
-        protoCmd->m_sOutput = m_ReadRangeType(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeType(protoCmd->m_Parsed);
         break;
     case SenseRange::cmdAlias:
-        protoCmd->m_sOutput = m_ReadRangeAlias(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeAlias(protoCmd->m_Parsed);
         break;
     case SenseRange::cmdAvail:
-        protoCmd->m_sOutput = m_ReadRangeAvail(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeAvail(protoCmd->m_Parsed);
         break;
     case SenseRange::cmdValue:
-        protoCmd->m_sOutput = m_ReadRangeValue(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeValue(protoCmd->m_Parsed);
         break;
     case SenseRange::cmdRejection:
-        protoCmd->m_sOutput = m_ReadRangeRejection(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeRejection(protoCmd->m_Parsed);
         break;
     case SenseRange::cmdOVRejection:
-        protoCmd->m_sOutput = m_ReadRangeOVRejection(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeOVRejection(protoCmd->m_Parsed);
         break;
     case SenseRange::cmdADWRejection:
-        protoCmd->m_sOutput = m_ReadRangeADWRejection(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadRangeADWRejection(protoCmd->m_Parsed);
         break;
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
-QString cSenseRange::m_ReadRangeType(QString &sInput)
+QString cSenseRange::m_ReadRangeType(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
-        return QString("%1").arg(m_nMMask); // we return mmode mask and sensortype here
+        return QString("%1").arg(m_pDescriptor->mmask); // we return mmode mask and sensortype here
     else
         return SCPI::scpiAnswer[SCPI::nak];
 
 }
 
 
-QString cSenseRange::m_ReadRangeAlias(QString &sInput)
+QString cSenseRange::m_ReadRangeAlias(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
         return m_sAlias;
     else
@@ -170,10 +148,8 @@ QString cSenseRange::m_ReadRangeAlias(QString &sInput)
 }
 
 
-QString cSenseRange::m_ReadRangeAvail(QString &sInput)
+QString cSenseRange::m_ReadRangeAvail(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
         if (m_bAvail)
@@ -186,45 +162,37 @@ QString cSenseRange::m_ReadRangeAvail(QString &sInput)
 }
 
 
-QString cSenseRange::m_ReadRangeValue(QString &sInput)
+QString cSenseRange::m_ReadRangeValue(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
-        return QString("%1").arg(m_fRValue);
+        return QString("%1").arg(m_pDescriptor->rValue);
     else
         return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
-QString cSenseRange::m_ReadRangeRejection(QString &sInput)
+QString cSenseRange::m_ReadRangeRejection(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
-        return QString("%1").arg(m_fRejection, 0, 'g', 8);
+        return QString("%1").arg(m_pDescriptor->rejection, 0, 'g', 8);
     else
         return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
-QString cSenseRange::m_ReadRangeOVRejection(QString &sInput)
+QString cSenseRange::m_ReadRangeOVRejection(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
-        return QString("%1").arg(m_fOVRejection, 0, 'g', 8);
+        return QString("%1").arg(m_pDescriptor->ovrejection, 0, 'g', 8);
     else
         return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
-QString cSenseRange::m_ReadRangeADWRejection(QString &sInput)
+QString cSenseRange::m_ReadRangeADWRejection(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
-        return QString("%1").arg(m_fADCRejection, 0, 'g', 8);
+        return QString("%1").arg(m_pDescriptor->adcrejection, 0, 'g', 8);
     else
         return SCPI::scpiAnswer[SCPI::nak];
 }
@@ -25,9 +25,25 @@ enum Commands
     cmdOVRejection,
     cmdADWRejection
 };
+
+// the fixed properties of a range, the tables live in the code that creates the ranges
+// and are shared by all channels (and clamps) using them
+struct cRangeDescriptor
+{
+    const char* name; // the range name
+    const char* alias; // the range alias name
+    bool avail; // range is avail after construction
+    double rValue; // upper range value
+    double rejection; // 100% rejection value
+    double ovrejection; // overload rejection value
+    double adcrejection; // the adc's maximum rejection
+    quint8 selCode; // selection code
+    quint16 mmask; // the possible measuring modes for this range
+};
 }
 
 class cATMEL;
+class cParsedCommand;
 class cMTJustData;
 class cSCPI;
 
@@ -36,12 +52,13 @@ class cSenseRange:public cSCPIConnection
     Q_OBJECT
 
 public:
-    cSenseRange(cSCPI* scpiinterface, QString name, QString alias, bool avail, double rValue, double rejection, double ovrejection, double adcrejection, quint8 rselcode, quint16 mmask, cMT310S2JustData* justdata);
+    cSenseRange(cSCPI* scpiinterface, const SenseRange::cRangeDescriptor* descriptor, cMT310S2JustData* justdata);
     ~cSenseRange();
     virtual void initSCPIConnection(QString leadingNodes);
     quint8 getAdjustmentStatus();
+    int getNotAdjustedCount();
 
-    QString& getName();
+    QString getName();
     double getUrvalue();
     quint8 getSelCode();
     quint16 getMMask();
@@ -52,29 +69,28 @@ public:
     void initJustData();
     void computeJustData();
 
+signals:
+    void notAdjustedChanged(int delta); // relayed from our adjustment data
+    void coefficientsChanged(); // same
+
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
 protected:
     cATMEL* m_pATMEL;
-    QString m_sName; // the range name
-    QString m_sAlias; // the range alias name
+    const SenseRange::cRangeDescriptor* m_pDescriptor; // the range's fixed properties
+    QString m_sName; // name and alias of the descriptor, converted once
+    QString m_sAlias;
     bool m_bAvail; // range io avail or not
-    double m_fRValue; // upper range value
-    double m_fRejection; // 100% rejection value
-    double m_fOVRejection; // overload rejection value
-    double m_fADCRejection; // the adc's maximum rejection
-    quint8 m_nSelCode; // selection code
-    quint16 m_nMMask; // the possible measuring modes for this range
     quint8 m_nMMode; // the actual measuring mode
 
-    QString m_ReadRangeType(QString& sInput);
-    QString m_ReadRangeAlias(QString& sInput);
-    QString m_ReadRangeAvail(QString& sInput);
-    QString m_ReadRangeValue(QString& sInput);
-    QString m_ReadRangeRejection(QString& sInput);
-    QString m_ReadRangeOVRejection(QString& sInput);
-    QString m_ReadRangeADWRejection(QString& sInput);
+    QString m_ReadRangeType(const cParsedCommand& cmd);
+    QString m_ReadRangeAlias(const cParsedCommand& cmd);
+    QString m_ReadRangeAvail(const cParsedCommand& cmd);
+    QString m_ReadRangeValue(const cParsedCommand& cmd);
+    QString m_ReadRangeRejection(const cParsedCommand& cmd);
+    QString m_ReadRangeOVRejection(const cParsedCommand& cmd);
+    QString m_ReadRangeADWRejection(const cParsedCommand& cmd);
 
     cMT310S2JustData* m_pJustdata;
 
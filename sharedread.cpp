@@ -0,0 +1,45 @@
+#include "sharedread.h"
+
+
+cSharedRead::cSharedRead(qint64 window)
+    :m_nWindow(window), m_bValid(false), m_nValue(0), m_nReadCount(0), m_nSavedCount(0)
+{
+}
+
+
+bool cSharedRead::take(quint16 &value)
+{
+    if (!m_bValid || m_Age.hasExpired(m_nWindow))
+        return false;
+
+    value = m_nValue;
+    m_nSavedCount++;
+    return true;
+}
+
+
+void cSharedRead::store(quint16 value)
+{
+    m_nValue = value;
+    m_bValid = true;
+    m_nReadCount++;
+    m_Age.start();
+}
+
+
+void cSharedRead::invalidate()
+{
+    m_bValid = false;
+}
+
+
+quint32 cSharedRead::getReadCount()
+{
+    return m_nReadCount;
+}
+
+
+quint32 cSharedRead::getSavedCount()
+{
+    return m_nSavedCount;
+}
@@ -0,0 +1,28 @@
+#ifndef SHAREDREAD_H
+#define SHAREDREAD_H
+
+#include <QElapsedTimer>
+
+// several clients often poll the same hardware status at the same moment. a result younger
+// than our window is handed to the following identical queries, so they need no i2c transaction
+
+class cSharedRead
+{
+public:
+    cSharedRead(qint64 window); // ms
+    bool take(quint16& value); // true if we have a result within window, it's counted as saved read
+    void store(quint16 value); // after a successful hardware read
+    void invalidate(); // we changed the hardware state ourself
+    quint32 getReadCount(); // hardware reads
+    quint32 getSavedCount(); // hardware reads we could spare
+
+private:
+    QElapsedTimer m_Age;
+    qint64 m_nWindow;
+    bool m_bValid;
+    quint16 m_nValue;
+    quint32 m_nReadCount;
+    quint32 m_nSavedCount;
+};
+
+#endif // SHAREDREAD_H
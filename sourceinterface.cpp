@@ -11,6 +11,13 @@
 #include "protonetcommand.h"
 
 
+static const cSCPIDelegateDescriptor SourceCommands[] =
+{
+    { "SOURCE",         "VERSION", SCPI::isQuery, SourceSystem::cmdVersion },
+    { "SOURCE:CHANNEL", "CATALOG", SCPI::isQuery, SourceSystem::cmdChannelCat },
+};
+
+
 cSourceInterface::cSourceInterface(cMT310S2dServer *server)
     :m_pMyServer(server)
 {
@@ -47,22 +54,15 @@ cSourceInterface::~cSourceInterface()
 
 void cSourceInterface::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1SOURCE").arg(leadingNodes),"VERSION",SCPI::isQuery, m_pSCPIInterface, SourceSystem::cmdVersion);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SOURCE:CHANNEL").arg(leadingNodes),"CATALOG", SCPI::isQuery, m_pSCPIInterface, SourceSystem::cmdChannelCat);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, SourceCommands);
+    findDelegate(SourceSystem::cmdVersion)->setStaticReply(m_sVersion);
 
     for (int i = 0; i < m_ChannelList.count(); i++)
     {
         connect(m_ChannelList.at(i), SIGNAL(notifier(cNotificationString*)), this, SIGNAL(notifier(cNotificationString*)));
-        connect(m_ChannelList.at(i), SIGNAL(cmdExecutionDone(cProtonetCommand*)), this, SIGNAL(cmdExecutionDone(cProtonetCommand*)));
         m_ChannelList.at(i)->initSCPIConnection(QString("%1SOURCE").arg(leadingNodes));
     }
 }
@@ -103,7 +103,7 @@ void cSourceInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
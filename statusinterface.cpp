@@ -3,10 +3,20 @@
 #include "adjustment.h"
 #include "statusinterface.h"
 #include "protonetcommand.h"
+#include "parsedcommand.h"
 
 extern cATMEL* pAtmel;
 
 
+static const cSCPIDelegateDescriptor StatusCommands[] =
+{
+    { "STATUS",            "DEVICE",        SCPI::isQuery, StatusSystem::cmdDevice },
+    { "STATUS",            "ADJUSTMENT",    SCPI::isQuery, StatusSystem::cmdAdjustment },
+    { "STATUS",            "AUTHORIZATION", SCPI::isQuery, StatusSystem::cmdAuthorization },
+    { "STATUS:SHAREDREAD", "STATISTIC",     SCPI::isQuery, StatusSystem::cmdSharedReadStatistic },
+};
+
+
 cStatusInterface::cStatusInterface(cMT310S2dServer* server)
     :m_pMyServer(server)
 {
@@ -16,26 +26,16 @@ cStatusInterface::cStatusInterface(cMT310S2dServer* server)
 
 void cStatusInterface::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1STATUS").arg(leadingNodes),"DEVICE",SCPI::isQuery, m_pSCPIInterface, StatusSystem::cmdDevice);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1STATUS").arg(leadingNodes),"ADJUSTMENT", SCPI::isQuery, m_pSCPIInterface, StatusSystem::cmdAdjustment);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1STATUS").arg(leadingNodes),"AUTHORIZATION", SCPI::isQuery, m_pSCPIInterface, StatusSystem::cmdAuthorization);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, StatusCommands);
 }
 
 
 void cStatusInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
 {
-    cSCPICommand cmd = protoCmd->m_sInput;
+    const cParsedCommand& cmd = protoCmd->m_Parsed;
 
     if (cmd.isQuery())
     {
@@ -45,26 +45,34 @@ void cStatusInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
             protoCmd->m_sOutput = QString("%1").arg(getDeviceStatus());
             break; // StatusDevice
         case StatusSystem::cmdAdjustment:
-            protoCmd->m_sOutput = QString("%1").arg(m_pMyServer->m_pAdjHandler->getAdjustmentStatus());
+            emit notifier(&notifierAdjustment);
+            protoCmd->m_sOutput = notifierAdjustment.getString();
             break; // StatusAdjustment
         case StatusSystem::cmdAuthorization:
             protoCmd->m_sOutput = QString("%1").arg(getAuthorizationStatus());
             break; // StatusAuthorization
+        case StatusSystem::cmdSharedReadStatistic:
+            protoCmd->m_sOutput = QString("%1;%2").arg(pAtmel->getSharedReadCount()).arg(pAtmel->getSavedReadCount());
+            break; // hardware reads done;spared by sharing
         }
     }
     else
         protoCmd->m_sOutput = SCPI::scpiAnswer[SCPI::nak];
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
-quint8 cStatusInterface::getDeviceStatus()
+void cStatusInterface::setNotifierAdjustment()
 {
-    QString s;
+    notifierAdjustment = QString("%1").arg(m_pMyServer->m_pAdjHandler->getAdjustmentStatus());
+}
+
 
-    if (pAtmel->readDeviceName(s) == cmddone) // no problem reading from atmel
+quint8 cStatusInterface::getDeviceStatus()
+{
+    if (pAtmel->readDeviceAvailShared() == cmddone) // no problem reading from atmel
         return 1; // means device available
     else
         return 0;
@@ -77,7 +85,7 @@ quint8 cStatusInterface::getAuthorizationStatus()
     bool enable;
 
     ret  = 0;
-    if (pAtmel->getEEPROMAccessEnable(enable) == cmddone)
+    if (pAtmel->getEEPROMAccessEnableShared(enable) == cmddone)
     {
         if (enable)
             ret = 1;
@@ -8,6 +8,7 @@
 #include "mt310s2d.h"
 #include "scpiconnection.h"
 #include "scpidelegate.h"
+#include "notificationstring.h"
 
 namespace StatusSystem
 {
@@ -16,7 +17,8 @@ enum StatusCommands
 {
     cmdDevice,
     cmdAdjustment,
-    cmdAuthorization
+    cmdAuthorization,
+    cmdSharedReadStatistic
 };
 }
 
@@ -32,6 +34,9 @@ public:
     cStatusInterface(cMT310S2dServer *server);
     virtual void initSCPIConnection(QString leadingNodes);
 
+public slots:
+    void setNotifierAdjustment(); // called when one of our adjustment objects changed its status
+
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
@@ -39,6 +44,8 @@ private:
     cMT310S2dServer* m_pMyServer;
     quint8 getDeviceStatus();
     quint8 getAuthorizationStatus();
+
+    cNotificationString notifierAdjustment;
 };
 
 #endif // STATUSINTERFACE_H
@@ -1,82 +1,64 @@
+#include <QTimer>
 #include <scpi.h>
-#include <scpicommand.h>
 
 #include "mt310s2d.h"
 #include "atmel.h"
 #include "adjustment.h"
 #include "scpidelegate.h"
+#include "scpirouter.h"
 #include "systeminfo.h"
 #include "systeminterface.h"
 #include "senseinterface.h"
 #include "protonetcommand.h"
+#include "parsedcommand.h"
+#include "job.h"
+#include "jobinterface.h"
 
 extern cATMEL* pAtmel;
 
+static const cSCPIDelegateDescriptor SystemCommands[] =
+{
+    { "SYSTEM:VERSION",          "SERVER",     SCPI::isQuery,                 SystemSystem::cmdVersionServer },
+    { "SYSTEM:VERSION",          "DEVICE",     SCPI::isQuery,                 SystemSystem::cmdVersionDevice },
+    { "SYSTEM:VERSION",          "PCB",        SCPI::isQuery | SCPI::isCmdwP, SystemSystem::cmdVersionPCB },
+    { "SYSTEM:VERSION",          "CTRL",       SCPI::isQuery,                 SystemSystem::cmdVersionCTRL },
+    { "SYSTEM:VERSION",          "FPGA",       SCPI::isQuery,                 SystemSystem::cmdVersionFPGA },
+    { "SYSTEM",                  "SERIAL",     SCPI::isQuery | SCPI::isCmdwP, SystemSystem::cmdSerialNumber },
+    { "SYSTEM:UPDATE:CONTROLER", "BOOTLOADER", SCPI::isCmd,                   SystemSystem::cmdUpdateControlerBootloader },
+    { "SYSTEM:UPDATE:CONTROLER", "PROGRAM",    SCPI::isCmd,                   SystemSystem::cmdUpdateControlerProgram },
+    { "SYSTEM:UPDATE:CONTROLER", "FLASH",      SCPI::isCmdwP,                 SystemSystem::cmdUpdateControlerFlash },
+    { "SYSTEM:UPDATE:CONTROLER", "EEPROM",     SCPI::isCmdwP,                 SystemSystem::cmdUpdateControlerEEprom },
+    { "SYSTEM:ADJUSTMENT:FLASH", "WRITE",      SCPI::isCmd,                   SystemSystem::cmdAdjFlashWrite },
+    { "SYSTEM:ADJUSTMENT:FLASH", "READ",       SCPI::isCmd,                   SystemSystem::cmdAdjFlashRead },
+    { "SYSTEM:ADJUSTMENT",       "XML",        SCPI::isQuery | SCPI::isCmdwP, SystemSystem::cmdAdjXMLImportExport },
+    { "SYSTEM:ADJUSTMENT:XML",   "WRITE",      SCPI::isCmdwP,                 SystemSystem::cmdAdjXMLWrite },
+    { "SYSTEM:ADJUSTMENT:XML",   "READ",       SCPI::isCmdwP,                 SystemSystem::cmdAdjXMLRead },
+    { "SYSTEM:ADJUSTMENT:XML",   "BEGIN",      SCPI::isCmd,                   SystemSystem::cmdAdjXMLBegin },
+    { "SYSTEM:ADJUSTMENT:XML",   "APPEND",     SCPI::isCmdwP,                 SystemSystem::cmdAdjXMLAppend },
+    { "SYSTEM:ADJUSTMENT:XML",   "COMMIT",     SCPI::isCmd,                   SystemSystem::cmdAdjXMLCommit },
+    { "SYSTEM:ADJUSTMENT:FLASH", "CHKSUM",     SCPI::isQuery,                 SystemSystem::cmdAdjFlashChksum },
+    { "SYSTEM:INTERFACE",        "READ",       SCPI::isQuery,                 SystemSystem::cmdInterfaceRead },
+    { "SYSTEM:INTERFACE",        "GENERATION", SCPI::isQuery,                 SystemSystem::cmdInterfaceGeneration },
+};
+
+
 cSystemInterface::cSystemInterface(cMT310S2dServer *server)
     :m_pMyServer(server)
 {
     m_pSCPIInterface = m_pMyServer->getSCPIInterface();
+    m_nModelXMLGeneration = 0;
+    m_bModelXMLValid = false;
+    m_bModelNotificationPending = false;
+    setNotifierInterfaceGeneration();
 }
 
 
 void cSystemInterface::initSCPIConnection(QString leadingNodes)
 {
-    cSCPIDelegate* delegate;
-
     if (leadingNodes != "")
         leadingNodes += ":";
 
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:VERSION").arg(leadingNodes),"SERVER", SCPI::isQuery, m_pSCPIInterface, SystemSystem::cmdVersionServer);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:VERSION").arg(leadingNodes),"DEVICE", SCPI::isQuery, m_pSCPIInterface, SystemSystem::cmdVersionDevice);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:VERSION").arg(leadingNodes), "PCB", SCPI::isQuery | SCPI::isCmdwP, m_pSCPIInterface, SystemSystem::cmdVersionPCB);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:VERSION").arg(leadingNodes), "CTRL", SCPI::isQuery, m_pSCPIInterface, SystemSystem::cmdVersionCTRL);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:VERSION").arg(leadingNodes), "FPGA", SCPI::isQuery, m_pSCPIInterface, SystemSystem::cmdVersionFPGA);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM").arg(leadingNodes), "SERIAL", SCPI::isQuery | SCPI::isCmdwP , m_pSCPIInterface, SystemSystem::cmdSerialNumber);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:UPDATE:CONTROLER").arg(leadingNodes), "BOOTLOADER", SCPI::isCmd, m_pSCPIInterface, SystemSystem::cmdUpdateControlerBootloader);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:UPDATE:CONTROLER").arg(leadingNodes), "PROGRAM", SCPI::isCmd, m_pSCPIInterface, SystemSystem::cmdUpdateControlerProgram);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:UPDATE:CONTROLER").arg(leadingNodes), "FLASH", SCPI::isCmdwP, m_pSCPIInterface, SystemSystem::cmdUpdateControlerFlash);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:UPDATE:CONTROLER").arg(leadingNodes), "EEPROM", SCPI::isCmdwP, m_pSCPIInterface, SystemSystem::cmdUpdateControlerEEprom);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:FLASH").arg(leadingNodes), "WRITE", SCPI::isCmd, m_pSCPIInterface, SystemSystem::cmdAdjFlashWrite);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:FLASH").arg(leadingNodes), "READ", SCPI::isCmd, m_pSCPIInterface, SystemSystem::cmdAdjFlashRead);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT").arg(leadingNodes), "XML", SCPI::isQuery | SCPI::isCmdwP, m_pSCPIInterface, SystemSystem::cmdAdjXMLImportExport);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:XML").arg(leadingNodes), "WRITE", SCPI::isCmdwP, m_pSCPIInterface, SystemSystem::cmdAdjXMLWrite);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:XML").arg(leadingNodes), "READ", SCPI::isCmdwP, m_pSCPIInterface, SystemSystem::cmdAdjXMLRead);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:ADJUSTMENT:FLASH").arg(leadingNodes), "CHKSUM", SCPI::isQuery, m_pSCPIInterface, SystemSystem::cmdAdjFlashChksum);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
-    delegate = new cSCPIDelegate(QString("%1SYSTEM:INTERFACE").arg(leadingNodes), "READ", SCPI::isQuery, m_pSCPIInterface, SystemSystem::cmdInterfaceRead);
-    m_DelegateList.append(delegate);
-    connect(delegate, SIGNAL(execute(int, cProtonetCommand*)), this, SLOT(executeCommand(int, cProtonetCommand*)));
+    addDelegates(leadingNodes, SystemCommands);
 }
 
 
@@ -85,67 +67,78 @@ void cSystemInterface::executeCommand(int cmdCode, cProtonetCommand *protoCmd)
     switch (cmdCode)
     {
     case SystemSystem::cmdVersionServer:
-        protoCmd->m_sOutput = m_ReadServerVersion(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadServerVersion(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdVersionDevice:
-        protoCmd->m_sOutput = m_ReadDeviceVersion(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadDeviceVersion(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdVersionPCB:
-        protoCmd->m_sOutput = m_ReadWritePCBVersion(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadWritePCBVersion(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdVersionCTRL:
-        protoCmd->m_sOutput = m_ReadCTRLVersion(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadCTRLVersion(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdVersionFPGA:
-        protoCmd->m_sOutput = m_ReadFPGAVersion(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadFPGAVersion(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdSerialNumber:
-        protoCmd->m_sOutput = m_ReadWriteSerialNumber(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_ReadWriteSerialNumber(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdUpdateControlerBootloader:
-        protoCmd->m_sOutput = m_StartControlerBootloader(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_StartControlerBootloader(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdUpdateControlerProgram:
-        protoCmd->m_sOutput = m_StartControlerProgram(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_StartControlerProgram(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdUpdateControlerFlash:
-        protoCmd->m_sOutput = m_LoadFlash(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_LoadFlash(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdUpdateControlerEEprom:
-        protoCmd->m_sOutput = m_LoadEEProm(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_LoadEEProm(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdAdjFlashWrite:
-        protoCmd->m_sOutput = m_AdjFlashWrite(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_AdjFlashWrite(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdAdjFlashRead:
-        protoCmd->m_sOutput = m_AdjFlashRead(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_AdjFlashRead(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdAdjXMLImportExport:
-        protoCmd->m_sOutput = m_AdjXmlImportExport(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_AdjXmlImportExport(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdAdjXMLWrite:
-        protoCmd->m_sOutput = m_AdjXMLWrite(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_AdjXMLWrite(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdAdjXMLRead:
-        protoCmd->m_sOutput = m_AdjXMLRead(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_AdjXMLRead(protoCmd->m_Parsed);
+        break;
+    case SystemSystem::cmdAdjXMLBegin:
+        protoCmd->m_sOutput = m_AdjXMLUploadBegin(protoCmd);
+        break;
+    case SystemSystem::cmdAdjXMLAppend:
+        protoCmd->m_sOutput = m_AdjXMLUploadAppend(protoCmd);
+        break;
+    case SystemSystem::cmdAdjXMLCommit:
+        protoCmd->m_sOutput = m_AdjXMLUploadCommit(protoCmd);
         break;
     case SystemSystem::cmdAdjFlashChksum:
-        protoCmd->m_sOutput = m_AdjFlashChksum(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_AdjFlashChksum(protoCmd->m_Parsed);
         break;
     case SystemSystem::cmdInterfaceRead:
-        protoCmd->m_sOutput = m_InterfaceRead(protoCmd->m_sInput);
+        protoCmd->m_sOutput = m_InterfaceRead(protoCmd->m_Parsed);
+        break;
+    case SystemSystem::cmdInterfaceGeneration:
+        protoCmd->m_sOutput = m_InterfaceGeneration(protoCmd->m_Parsed);
         break;
     }
 
     if (protoCmd->m_bwithOutput)
-        emit cmdExecutionDone(protoCmd);
+        protoCmd->sendAnswer();
 }
 
 
-QString cSystemInterface::m_ReadServerVersion(QString &sInput)
+QString cSystemInterface::m_ReadServerVersion(const cParsedCommand &cmd)
 {
     QString s;
-    cSCPICommand cmd = sInput;
 
     if ( cmd.isQuery() )
     {
@@ -158,10 +151,8 @@ QString cSystemInterface::m_ReadServerVersion(QString &sInput)
 }
 
 
-QString cSystemInterface::m_ReadDeviceVersion(QString &sInput)
+QString cSystemInterface::m_ReadDeviceVersion(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
         if (m_pMyServer->m_pSystemInfo->dataRead())
@@ -174,10 +165,9 @@ QString cSystemInterface::m_ReadDeviceVersion(QString &sInput)
 }
 
 
-QString cSystemInterface::m_ReadDeviceName(QString& sInput)
+QString cSystemInterface::m_ReadDeviceName(const cParsedCommand &cmd)
 {
     QString s;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
@@ -191,11 +181,10 @@ QString cSystemInterface::m_ReadDeviceName(QString& sInput)
 }
 
 
-QString cSystemInterface::m_ReadWritePCBVersion(QString &sInput)
+QString cSystemInterface::m_ReadWritePCBVersion(const cParsedCommand &cmd)
 {
     QString s;
     int ret = cmdfault;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
@@ -208,7 +197,7 @@ QString cSystemInterface::m_ReadWritePCBVersion(QString &sInput)
     {
         if (cmd.isCommand(1))
         {
-            QString Version = cmd.getParam(0);
+            QString Version = cmd.getParam(0).toString();
             ret = pAtmel->writePCBVersion(Version);
             m_pMyServer->m_pSystemInfo->getSystemInfo(); // read back info
         }
@@ -220,10 +209,9 @@ QString cSystemInterface::m_ReadWritePCBVersion(QString &sInput)
 }
 
 
-QString cSystemInterface::m_ReadCTRLVersion(QString &sInput)
+QString cSystemInterface::m_ReadCTRLVersion(const cParsedCommand &cmd)
 {
     QString s;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
@@ -238,10 +226,8 @@ QString cSystemInterface::m_ReadCTRLVersion(QString &sInput)
 }
 
 
-QString cSystemInterface::m_ReadFPGAVersion(QString &sInput)
+QString cSystemInterface::m_ReadFPGAVersion(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
         if (m_pMyServer->m_pSystemInfo->dataRead())
@@ -255,11 +241,10 @@ QString cSystemInterface::m_ReadFPGAVersion(QString &sInput)
 }
 
 
-QString cSystemInterface::m_ReadWriteSerialNumber(QString &sInput)
+QString cSystemInterface::m_ReadWriteSerialNumber(const cParsedCommand &cmd)
 {
     atmelRM ret = cmdfault;
     QString s;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
@@ -274,7 +259,7 @@ QString cSystemInterface::m_ReadWriteSerialNumber(QString &sInput)
     {
         if (cmd.isCommand(1))
         {
-            QString Serial = cmd.getParam(0);
+            QString Serial = cmd.getParam(0).toString();
             ret = pAtmel->writeSerialNumber(Serial);
             m_pMyServer->m_pSystemInfo->getSystemInfo(); // read back info
         }
@@ -286,14 +271,15 @@ QString cSystemInterface::m_ReadWriteSerialNumber(QString &sInput)
 }
 
 
-QString cSystemInterface::m_StartControlerBootloader(QString& sInput)
+QString cSystemInterface::m_StartControlerBootloader(const cParsedCommand &cmd)
 {
     QString s;
     int ret = cmdfault;
-    cSCPICommand cmd = sInput;
 
-    if (cmd.isCommand(1) && (cmd.getParam(0) == ""))
+    if (cmd.isCommand(1) && cmd.getParam(0).isEmpty())
     {
+        if (cAtmelLoadJob::isPending()) // flash or eeprom are just being programmed
+            return SCPI::scpiAnswer[SCPI::busy];
         ret = pAtmel->startBootLoader();
     }
     m_genAnswer(ret, s);
@@ -301,14 +287,15 @@ QString cSystemInterface::m_StartControlerBootloader(QString& sInput)
 }
 
 
-QString cSystemInterface::m_StartControlerProgram(QString &sInput)
+QString cSystemInterface::m_StartControlerProgram(const cParsedCommand &cmd)
 {
     QString s;
     int ret = cmdfault;
-    cSCPICommand cmd = sInput;
 
-    if (cmd.isCommand(1) && (cmd.getParam(0) == ""))
+    if (cmd.isCommand(1) && cmd.getParam(0).isEmpty())
     {
+        if (cAtmelLoadJob::isPending()) // flash or eeprom are just being programmed
+            return SCPI::scpiAnswer[SCPI::busy];
         ret = pAtmel->startProgram();
     }
     m_genAnswer(ret, s);
@@ -316,72 +303,49 @@ QString cSystemInterface::m_StartControlerProgram(QString &sInput)
 }
 
 
-QString cSystemInterface::m_LoadFlash(QString &sInput)
+QString cSystemInterface::m_LoadFlash(const cParsedCommand &cmd)
 {
-    QString s;
-    int ret = cmdfault;
-    cSCPICommand cmd = sInput;
-
     if (cmd.isCommand(1))
     {
-        QString filename = cmd.getParam(0);
-        cIntelHexFileIO IntelHexData;
-        if (IntelHexData.ReadHexFile(filename))
-        {
-           ret = pAtmel->loadFlash(IntelHexData);
-        }
-        else
-            ret = cmdexecfault;
+        QString filename = cmd.getParam(0).toString();
+        return QString("%1").arg(m_pMyServer->m_pJobInterface->addJob(new cAtmelLoadJob(blWriteFlashBlock, filename)));
     }
-    m_genAnswer(ret, s);
-    return s;
+
+    return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
-QString cSystemInterface::m_LoadEEProm(QString &sInput)
+QString cSystemInterface::m_LoadEEProm(const cParsedCommand &cmd)
 {
-    QString s;
-    int ret = 1;
-    cSCPICommand cmd = sInput;
-
     if (cmd.isCommand(1))
     {
-        QString filename = cmd.getParam(0);
-        cIntelHexFileIO IntelHexData;
-        if (IntelHexData.ReadHexFile(filename))
-        {
-            ret = pAtmel->loadEEprom(IntelHexData);
-        }
-        else
-            ret = cmdexecfault;
+        QString filename = cmd.getParam(0).toString();
+        return QString("%1").arg(m_pMyServer->m_pJobInterface->addJob(new cAtmelLoadJob(blWriteEEPromBlock, filename)));
     }
-    m_genAnswer(ret, s);
-    return s;
+
+    return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
-QString cSystemInterface::m_AdjFlashWrite(QString &sInput)
+QString cSystemInterface::m_AdjFlashWrite(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
-    if (cmd.isCommand(1) && (cmd.getParam(0) == ""))
+    if (cmd.isCommand(1) && cmd.getParam(0).isEmpty())
     {
-        if (m_pMyServer->m_pSenseInterface->exportAdjFlash())
-            return SCPI::scpiAnswer[SCPI::ack];
-        else
-            return SCPI::scpiAnswer[SCPI::errexec];
+        if (m_pMyServer->m_pSenseInterface->isFlashJobPending())
+            return SCPI::scpiAnswer[SCPI::busy];
+        return QString("%1").arg(m_pMyServer->m_pJobInterface->addJob(new cAdjFlashWriteJob(m_pMyServer->m_pSenseInterface)));
     }
 
     return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
-QString cSystemInterface::m_AdjFlashRead(QString &sInput)
+QString cSystemInterface::m_AdjFlashRead(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
-    if (cmd.isCommand(1) && (cmd.getParam(0) == ""))
+    if (cmd.isCommand(1) && cmd.getParam(0).isEmpty())
     {
+        if (m_pMyServer->m_pSenseInterface->isFlashJobPending()) // we would read a half written image
+            return SCPI::scpiAnswer[SCPI::busy];
         if (m_pMyServer->m_pSenseInterface->importAdjFlash())
             return SCPI::scpiAnswer[SCPI::ack];
         else
@@ -392,42 +356,97 @@ QString cSystemInterface::m_AdjFlashRead(QString &sInput)
 }
 
 
-QString cSystemInterface::m_AdjXmlImportExport(QString &sInput)
+QString cSystemInterface::m_AdjXmlImportExport(const cParsedCommand &cmd)
 {
     QString s;
-    cSCPICommand cmd = sInput;
 
     if (cmd.isQuery())
     {
         s = m_pMyServer->m_pSenseInterface->exportXMLString(-1);
-        s.replace("\n","");
     }
     else
     {
-        QString XML = cmd.getParam();
-        if (!m_pMyServer->m_pSenseInterface->importAdjXMLString(XML))
-            s = SCPI::errxml;
-        else
-        {
-            m_pMyServer->m_pSenseInterface->m_ComputeSenseAdjData();
-            if (!m_pMyServer->m_pSenseInterface->exportAdjFlash())
-                s = SCPI::scpiAnswer[SCPI::errexec];
-            else
-                s = SCPI::scpiAnswer[SCPI::ack];
-        }
+        QString XML = cmd.getRawParam().toString();
+        s = m_AdjXMLImport(XML);
     }
 
     return s;
 }
 
 
-QString cSystemInterface::m_AdjXMLWrite(QString &sInput)
+QString cSystemInterface::m_AdjXMLImport(QString &XML)
 {
-    cSCPICommand cmd = sInput;
+    cSenseInterface* pSense = m_pMyServer->m_pSenseInterface;
+
+    if (pSense->isFlashJobPending())
+        return SCPI::scpiAnswer[SCPI::busy];
+
+    if (!pSense->importAdjXMLString(XML))
+        return SCPI::scpiAnswer[SCPI::errxml];
+
+    pSense->m_ComputeSenseAdjData();
+    return QString("%1").arg(m_pMyServer->m_pJobInterface->addJob(new cAdjFlashWriteJob(pSense))); // the flash is written by the job
+}
+
 
+QString cSystemInterface::m_AdjXMLUploadBegin(cProtonetCommand *protoCmd)
+{
+    if (protoCmd->m_Parsed.isCommand(0))
+    {
+        if (!m_XMLUpload.begin(protoCmd))
+            return SCPI::scpiAnswer[SCPI::busy]; // another client is uploading
+        return SCPI::scpiAnswer[SCPI::ack];
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cSystemInterface::m_AdjXMLUploadAppend(cProtonetCommand *protoCmd)
+{
+    const cParsedCommand& cmd = protoCmd->m_Parsed;
+
+    if (!cmd.isQuery() && (cmd.getParamCount() > 0))
+    {
+        if (m_XMLUpload.isBusy(protoCmd))
+            return SCPI::scpiAnswer[SCPI::busy];
+
+        // the chunk is taken as sent, xml data contains ; and blanks itself
+        if (m_XMLUpload.append(protoCmd, cmd.getRawParam()))
+            return SCPI::scpiAnswer[SCPI::ack];
+        else
+            return SCPI::scpiAnswer[SCPI::errexec];
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cSystemInterface::m_AdjXMLUploadCommit(cProtonetCommand *protoCmd)
+{
+    if (protoCmd->m_Parsed.isCommand(0))
+    {
+        if (m_XMLUpload.isBusy(protoCmd))
+            return SCPI::scpiAnswer[SCPI::busy];
+        if (!m_XMLUpload.isActive(protoCmd))
+            return SCPI::scpiAnswer[SCPI::errexec];
+        if (m_pMyServer->m_pSenseInterface->isFlashJobPending())
+            return SCPI::scpiAnswer[SCPI::busy]; // the upload stays, it can be committed again later
+
+        QString answer = m_AdjXMLImport(m_XMLUpload.data());
+        m_XMLUpload.clear();
+        return answer;
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
+
+QString cSystemInterface::m_AdjXMLWrite(const cParsedCommand &cmd)
+{
     if (cmd.isCommand(1))
     {
-        QString filename = cmd.getParam(0);
+        QString filename = cmd.getParam(0).toString();
         if (m_pMyServer->m_pSenseInterface->exportAdjXML(filename))
             return SCPI::scpiAnswer[SCPI::ack];
         else
@@ -438,10 +457,8 @@ QString cSystemInterface::m_AdjXMLWrite(QString &sInput)
 }
 
 
-QString cSystemInterface::m_AdjXMLRead(QString &sInput)
+QString cSystemInterface::m_AdjXMLRead(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isCommand(1))
     {
         bool enable = false;
@@ -449,7 +466,7 @@ QString cSystemInterface::m_AdjXMLRead(QString &sInput)
         {
             if (enable)
             {
-                QString filename = cmd.getParam(0);
+                QString filename = cmd.getParam(0).toString();
                 if (m_pMyServer->m_pSenseInterface->importAdjXML(filename))
                     return SCPI::scpiAnswer[SCPI::ack];
                 else
@@ -466,10 +483,8 @@ QString cSystemInterface::m_AdjXMLRead(QString &sInput)
 }
 
 
-QString cSystemInterface::m_AdjFlashChksum(QString &sInput)
+QString cSystemInterface::m_AdjFlashChksum(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
-
     if (cmd.isQuery())
     {
         QString s = QString("0x%1").arg(m_pMyServer->m_pSenseInterface->getChecksum()); // hex output
@@ -480,21 +495,62 @@ QString cSystemInterface::m_AdjFlashChksum(QString &sInput)
 }
 
 
-QString cSystemInterface::m_InterfaceRead(QString &sInput)
+QString cSystemInterface::m_InterfaceRead(const cParsedCommand &cmd)
 {
-    cSCPICommand cmd = sInput;
+    if (cmd.isQuery())
+    {
+        // walking the whole command tree is expensive, we only do it after the model changed
+        // adding a route changes the generation too
+        quint32 generation = cSCPIDelegate::getModelGeneration();
+        if (!m_bModelXMLValid || (generation != m_nModelXMLGeneration))
+        {
+            m_sModelXML.clear();
+            m_pMyServer->getSCPIInterface()->exportSCPIModelXML(m_sModelXML);
+
+            // routed commands are not in the scpi tree, we add their patterns inside the root element
+            int pos = m_sModelXML.lastIndexOf("</");
+            if (pos >= 0)
+                m_sModelXML.insert(pos, m_pMyServer->getSCPIRouter()->exportXML());
+            m_nModelXMLGeneration = generation;
+            m_bModelXMLValid = true;
+        }
+        return m_sModelXML;
+    }
+    else
+        return SCPI::scpiAnswer[SCPI::nak];
+}
+
 
+QString cSystemInterface::m_InterfaceGeneration(const cParsedCommand &cmd)
+{
     if (cmd.isQuery())
     {
-        QString s;
-        m_pMyServer->getSCPIInterface()->exportSCPIModelXML(s);
-        return s;
+        emit notifier(&notifierInterfaceGeneration);
+        return notifierInterfaceGeneration.getString();
     }
     else
         return SCPI::scpiAnswer[SCPI::nak];
 }
 
 
+void cSystemInterface::scpiModelChanged()
+{
+    // a clamp brings or takes many delegates at once, so we notify our clients once after the whole burst is done
+    if (!m_bModelNotificationPending)
+    {
+        m_bModelNotificationPending = true;
+        QTimer::singleShot(0, this, SLOT(setNotifierInterfaceGeneration()));
+    }
+}
+
+
+void cSystemInterface::setNotifierInterfaceGeneration()
+{
+    m_bModelNotificationPending = false;
+    notifierInterfaceGeneration = QString("%1").arg(cSCPIDelegate::getModelGeneration());
+}
+
+
 void cSystemInterface::m_genAnswer(int select, QString &answer)
 {
     switch (select)
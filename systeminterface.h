@@ -6,6 +6,8 @@
 #include <scpi.h>
 
 #include "scpiconnection.h"
+#include "uploadbuffer.h"
+#include "notificationstring.h"
 
 namespace SystemSystem
 {
@@ -27,14 +29,19 @@ enum SystemCommands
     cmdAdjXMLImportExport,
     cmdAdjXMLWrite,
     cmdAdjXMLRead,
+    cmdAdjXMLBegin,
+    cmdAdjXMLAppend,
+    cmdAdjXMLCommit,
     cmdAdjFlashChksum,
-    cmdInterfaceRead
+    cmdInterfaceRead,
+    cmdInterfaceGeneration
 };
 }
 
 
 class cMT310S2dServer;
 class adjFlash;
+class cParsedCommand;
 
 class cSystemInterface: public cSCPIConnection
 {
@@ -44,31 +51,50 @@ public:
     cSystemInterface(cMT310S2dServer* server);
     virtual void initSCPIConnection(QString leadingNodes);
 
+public slots:
+    void scpiModelChanged(); // delegates were added or removed, f.e. by clamp attach/detach
+
 protected slots:
     virtual void executeCommand(int cmdCode, cProtonetCommand* protoCmd);
 
+private slots:
+    void setNotifierInterfaceGeneration();
+
 private:
     cMT310S2dServer* m_pMyServer;
-    QString m_ReadServerVersion(QString& sInput);
-    QString m_ReadDeviceVersion(QString& sInput);
-    QString m_ReadDeviceName(QString& sInput);
-    QString m_ReadWritePCBVersion(QString& sInput);
-    QString m_ReadCTRLVersion(QString& sInput);
-    QString m_ReadFPGAVersion(QString& sInput);
-    QString m_ReadWriteSerialNumber(QString& sInput);
-    QString m_StartControlerBootloader(QString& sInput);
-    QString m_StartControlerProgram(QString& sInput);
-    QString m_LoadFlash(QString& sInput);
-    QString m_LoadEEProm(QString& sInput);
-    QString m_AdjFlashWrite(QString& sInput);
-    QString m_AdjFlashRead(QString& sInput);
-    QString m_AdjXmlImportExport(QString& sInput);
-    QString m_AdjXMLWrite(QString& sInput);
-    QString m_AdjXMLRead(QString& sInput);
-    QString m_AdjFlashChksum(QString& sInput);
-    QString m_InterfaceRead(QString& sInput);
+    QString m_ReadServerVersion(const cParsedCommand& cmd);
+    QString m_ReadDeviceVersion(const cParsedCommand& cmd);
+    QString m_ReadDeviceName(const cParsedCommand& cmd);
+    QString m_ReadWritePCBVersion(const cParsedCommand& cmd);
+    QString m_ReadCTRLVersion(const cParsedCommand& cmd);
+    QString m_ReadFPGAVersion(const cParsedCommand& cmd);
+    QString m_ReadWriteSerialNumber(const cParsedCommand& cmd);
+    QString m_StartControlerBootloader(const cParsedCommand& cmd);
+    QString m_StartControlerProgram(const cParsedCommand& cmd);
+    QString m_LoadFlash(const cParsedCommand& cmd);
+    QString m_LoadEEProm(const cParsedCommand& cmd);
+    QString m_AdjFlashWrite(const cParsedCommand& cmd);
+    QString m_AdjFlashRead(const cParsedCommand& cmd);
+    QString m_AdjXmlImportExport(const cParsedCommand& cmd);
+    QString m_AdjXMLWrite(const cParsedCommand& cmd);
+    QString m_AdjXMLRead(const cParsedCommand& cmd);
+    QString m_AdjXMLUploadBegin(cProtonetCommand* protoCmd);
+    QString m_AdjXMLUploadAppend(cProtonetCommand* protoCmd);
+    QString m_AdjXMLUploadCommit(cProtonetCommand* protoCmd);
+    QString m_AdjXMLImport(QString& XML);
+    QString m_AdjFlashChksum(const cParsedCommand& cmd);
+    QString m_InterfaceRead(const cParsedCommand& cmd);
+    QString m_InterfaceGeneration(const cParsedCommand& cmd);
 
     void m_genAnswer(int select, QString& answer);
+
+    cUploadBuffer m_XMLUpload; // chunked SYSTEM:ADJUSTMENT:XML
+
+    QString m_sModelXML; // exported scpi model, valid for m_nModelXMLGeneration
+    quint32 m_nModelXMLGeneration;
+    bool m_bModelXMLValid;
+    bool m_bModelNotificationPending;
+    cNotificationString notifierInterfaceGeneration;
 };
 
 
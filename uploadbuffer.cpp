@@ -0,0 +1,72 @@
+#include "uploadbuffer.h"
+#include "protonetcommand.h"
+
+
+cUploadBuffer::cUploadBuffer()
+    :m_bActive(false), m_pPeer(0)
+{
+}
+
+
+bool cUploadBuffer::begin(cProtonetCommand *protoCmd)
+{
+    if (isBusy(protoCmd))
+        return false;
+
+    m_sData.clear();
+    m_pPeer = protoCmd->m_pPeer;
+    m_ClientId = protoCmd->m_clientId;
+    m_IdleTimer.start();
+    m_bActive = true;
+    return true;
+}
+
+
+bool cUploadBuffer::append(cProtonetCommand *protoCmd, const QStringRef &chunk)
+{
+    if (!isActive(protoCmd))
+        return false;
+
+    if ( (m_sData.length() + chunk.length()) > MaxUploadSize )
+    {
+        clear(); // the whole upload is useless now
+        return false;
+    }
+
+    m_sData.append(chunk);
+    m_IdleTimer.start();
+    return true;
+}
+
+
+bool cUploadBuffer::isActive(cProtonetCommand *protoCmd)
+{
+    return m_bActive && isOwner(protoCmd);
+}
+
+
+bool cUploadBuffer::isBusy(cProtonetCommand *protoCmd)
+{
+    return m_bActive && !isOwner(protoCmd) && !m_IdleTimer.hasExpired(UploadIdleTimeout);
+}
+
+
+QString &cUploadBuffer::data()
+{
+    return m_sData;
+}
+
+
+void cUploadBuffer::clear()
+{
+    m_sData = QString();
+    m_bActive = false;
+    m_pPeer = 0;
+    m_ClientId.clear();
+}
+
+
+bool cUploadBuffer::isOwner(cProtonetCommand *protoCmd)
+{
+    return (protoCmd->m_pPeer == m_pPeer) && (protoCmd->m_clientId == m_ClientId);
+}
@@ -0,0 +1,39 @@
+#ifndef UPLOADBUFFER_H
+#define UPLOADBUFFER_H
+
+#include <QString>
+#include <QStringRef>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+// collects a large scpi parameter (e.g. adjustment xml) that is sent in several chunks
+// begin -> append ... append -> commit, so each single command only carries a small part
+// an upload belongs to the client that began it, others get busy until it is finished
+
+const int MaxUploadSize = 4 * 1024 * 1024; // characters
+const int UploadIdleTimeout = 30000; // ms, after that an abandoned upload no longer blocks others
+
+class XiQNetPeer;
+class cProtonetCommand;
+
+class cUploadBuffer
+{
+public:
+    cUploadBuffer();
+    bool begin(cProtonetCommand* protoCmd); // false if another client's upload is running
+    bool append(cProtonetCommand* protoCmd, const QStringRef& chunk); // false if it's not our upload or the buffer would get too large
+    bool isActive(cProtonetCommand* protoCmd); // an upload of this client is running
+    bool isBusy(cProtonetCommand* protoCmd); // an upload of another client is running
+    QString& data();
+    void clear(); // also releases the memory
+
+private:
+    bool isOwner(cProtonetCommand* protoCmd);
+    bool m_bActive;
+    XiQNetPeer* m_pPeer;
+    QByteArray m_ClientId;
+    QElapsedTimer m_IdleTimer;
+    QString m_sData;
+};
+
+#endif // UPLOADBUFFER_H